@@ -0,0 +1,235 @@
+// checks Add, Remove, reverse() and UndoHistory on random edit sequences,
+// built as a libFuzzer target by make fuzz or run on random input by make proptest
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "action.hpp"
+#include "position.hpp"
+namespace {
+const std::string_view alphabet{"ab ({})\t\xC3\xA9"};
+void check(bool ok, const char* what) {
+	if (!ok) {
+		std::cerr << "action property failed: " << what << std::endl;
+		std::abort();
+	}
+}
+// reads the input as a stream of choices, zeros once it runs out
+class Choices {
+   public:
+	Choices(const uint8_t* data, size_t size) : data{data}, size{size} {}
+	[[nodiscard]] bool empty() const {
+		return pos >= size;
+	}
+	uint8_t byte() {
+		return pos < size ? data[pos++] : 0;
+	}
+	// a number below bound, which must be > 0
+	size_t below(size_t bound) {
+		size_t value = 0;
+		for (size_t range = 1; range < bound; range <<= 8) {
+			value = value << 8 | byte();
+		}
+		return value % bound;
+	}
+	char from(std::string_view chars) {
+		return chars[below(chars.size())];
+	}
+	std::string line() {
+		std::string line(below(8), ' ');
+		for (auto& chr : line) {
+			chr = from(alphabet);
+		}
+		return line;
+	}
+	std::vector<std::string> text() {
+		std::vector<std::string> text(1 + below(4));
+		for (auto& line : text) {
+			line = this->line();
+		}
+		return text;
+	}
+
+   private:
+	const uint8_t* data;
+	size_t size;
+	size_t pos{0};
+};
+// applies edits the way the editor does, keeping both the undo history of a buffer and every
+// action unmerged
+class Harness {
+   public:
+	explicit Harness(const std::vector<std::string>& original)
+		: original{original}, lines{original} {}
+	void run(Choices& choices) {
+		while (!choices.empty()) {
+			step(choices);
+		}
+		const std::vector<std::string> edited = lines;
+		// undo and redo everything like Editor::undo() and Editor::redo()
+		while (std::shared_ptr<Action> action = history.undo()) {
+			(*action)(lines);
+			++merged_actions;
+		}
+		check(lines == original, "undoing the merged actions doesn't restore the text");
+		while (std::shared_ptr<Action> action = history.redo()) {
+			(*action)(lines);
+		}
+		check(lines == edited, "redoing the merged actions doesn't restore the edits");
+		for (auto it = unmerged.rbegin(); it < unmerged.rend(); ++it) {
+			(*(*it)->reverse())(lines);
+		}
+		check(lines == original, "undoing the unmerged actions doesn't restore the text");
+	}
+
+	size_t edits{0};
+	size_t merged_actions{0};
+
+   private:
+	void step(Choices& choices) {
+		const std::string& line = lines[cursor.line];
+		switch (choices.below(10)) {
+			case 0:
+			case 1:
+			case 2:
+			case 3:	 // typing
+				edit(Add(cursor.line, cursor.col,
+						 std::vector<std::string>{std::string(1, choices.from(alphabet))}));
+				break;
+			case 4:	 // enter
+				edit(Add(cursor.line, cursor.col, std::vector<std::string>{"", ""}));
+				break;
+			case 5:	 // backspace
+				if (cursor.col > 1) {
+					edit(Remove(cursor.line, cursor.col - 1,
+								std::vector<std::string>{line.substr(cursor.col - 2, 1)}));
+				} else if (cursor.line > 0) {
+					const size_t col = lines[cursor.line - 1].size() + 1;
+					edit(Remove(cursor.line - 1, col, std::vector<std::string>{"", ""}));
+				}
+				break;
+			case 6:	 // paste
+				edit(Add(cursor.line, cursor.col, choices.text()));
+				break;
+			case 7:	 // cut from the cursor to somewhere after it
+				edit(Remove(cursor.line, cursor.col, text_to(choices)));
+				break;
+			case 8:
+				cursor.line = choices.below(lines.size());
+				cursor.col = 1 + choices.below(lines[cursor.line].size() + 1);
+				history.close_merge_window();
+				break;
+			case 9:	 // a pause in typing
+				history.close_merge_window();
+				break;
+		}
+	}
+	// the text from the cursor to a later position within a few lines
+	std::vector<std::string> text_to(Choices& choices) {
+		const size_t end_line = std::min(lines.size() - 1, cursor.line + choices.below(4));
+		const std::string& last = lines[end_line];
+		if (end_line == cursor.line) {
+			const size_t length = choices.below(last.size() - cursor.col + 2);
+			return {last.substr(cursor.col - 1, length)};
+		}
+		std::vector<std::string> text{lines[cursor.line].substr(cursor.col - 1)};
+		text.insert(text.end(), lines.begin() + cursor.line + 1, lines.begin() + end_line);
+		text.push_back(last.substr(0, choices.below(last.size() + 1)));
+		return text;
+	}
+	// the lines an action at line reads or writes
+	[[nodiscard]] std::vector<std::string> window(size_t line, size_t count) const {
+		return {lines.begin() + line, lines.begin() + std::min(lines.size(), line + count)};
+	}
+	template <typename T>
+	void edit(T action) {
+		const size_t old_size = lines.size();
+		const std::vector<std::string> before = window(action.line, action.lines.size());
+		const Position end = action(lines);
+		const size_t new_size = lines.size();
+		const std::vector<std::string> after = window(action.line, action.lines.size());
+		if constexpr (std::is_same_v<T, Add>) {
+			check(end == action.get_end(), "Add doesn't return the end of the added text");
+		} else {
+			check(end == Position{action.line, action.col}, "Remove doesn't return its start");
+		}
+		(*action.reverse())(lines);
+		check(lines.size() == old_size && window(action.line, action.lines.size()) == before,
+			  "reverse() doesn't undo the action");
+		action(lines);
+		check(lines.size() == new_size && window(action.line, action.lines.size()) == after,
+			  "applying the action again gives different text");
+		cursor = end;
+		++edits;
+		unmerged.push_back(std::make_shared<T>(action));
+		// the merged action may reuse either action, so the history gets its own copy
+		history.push(std::make_shared<T>(action));
+	}
+
+	const std::vector<std::string>& original;
+	std::vector<std::string> lines;
+	Position cursor{0, 1};
+	UndoHistory history{};
+	std::vector<std::shared_ptr<Action>> unmerged{};
+};
+}  // namespace
+
+#if defined(LIBFUZZER)
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+	Choices choices{data, size};
+	std::vector<std::string> original(1 + choices.below(64));
+	for (auto& line : original) {
+		line = choices.line();
+	}
+	Harness harness{original};
+	harness.run(choices);
+	return 0;
+}
+#else
+// usage: action_proptest [runs] [buffer lines] [seed]
+int main(int argc, char* argv[]) {
+	const size_t runs = argc > 1 ? std::stoul(argv[1]) : 100;
+	const size_t buffer_lines = argc > 2 ? std::stoul(argv[2]) : 10000;
+	const uint64_t seed = argc > 3 ? std::stoull(argv[3]) : std::random_device{}();
+	std::cout << "seed " << seed << std::endl;
+	std::mt19937_64 rng{seed};
+	std::vector<uint8_t> input;
+	const auto random_input = [&](size_t size) {
+		input.resize(size);
+		for (auto& byte : input) {
+			byte = static_cast<uint8_t>(rng());
+		}
+		return Choices{input.data(), input.size()};
+	};
+	Choices text = random_input(buffer_lines * 8);
+	std::vector<std::string> original(buffer_lines);
+	for (auto& line : original) {
+		line = text.line();
+	}
+
+	size_t edits = 0;
+	size_t merged_actions = 0;
+	std::chrono::duration<double> elapsed{0};
+	for (size_t run = 0; run < runs; ++run) {
+		Choices choices = random_input(1024 + rng() % 8192);
+		// copying the buffer isn't part of the throughput
+		Harness harness{original};
+		const auto start = std::chrono::steady_clock::now();
+		harness.run(choices);
+		elapsed += std::chrono::steady_clock::now() - start;
+		edits += harness.edits;
+		merged_actions += harness.merged_actions;
+	}
+	std::cout << runs << " runs on " << buffer_lines << " lines, " << edits << " edits merged into "
+			  << merged_actions << " actions, " << static_cast<size_t>(edits / elapsed.count())
+			  << " edits/s" << std::endl;
+}
+#endif
\ No newline at end of file
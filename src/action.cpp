@@ -1,6 +1,7 @@
 #include "action.hpp"
 
 #include <memory>
+#include <stack>
 #include <utility>
 
 #include "position.hpp"
@@ -21,30 +22,23 @@ Position Action::get_end() const {
 	return Position{end_line, end_col};
 }
 std::shared_ptr<Action> Action::merge_if_adj(const std::shared_ptr<Action>& action1,
-											 const std::shared_ptr<Action>& action2,
-											 const std::vector<std::string>& lines) {
+											 const std::shared_ptr<Action>& action2) {
 	if (dynamic_cast<Add*>(action1.get()) != nullptr &&
 		dynamic_cast<Add*>(action2.get()) != nullptr) {
 		auto end = action1->get_end();
 		if (end.line == action2->line && end.col == action2->col && action2->lines.size() < 2) {
-			auto it = action2->lines.begin();
-			action1->lines.back().append(*it);
-			++it;
-			if (lines.size() > 1) {
-				action1->lines.insert(action1->lines.end(), it, action2->lines.end());
-			}
+			action1->lines.back().append(action2->lines.front());
 			return action1;
 		}
 	} else if (dynamic_cast<Remove*>(action1.get()) != nullptr &&
 			   dynamic_cast<Remove*>(action2.get()) != nullptr) {
 		auto end = action2->get_end();
 		if (end.line == action1->line && end.col == action1->col) {
+			// the later removal comes first in the text
 			auto it = action1->lines.begin();
 			action2->lines.back().append(*it);
 			++it;
-			if (lines.size() > 1) {
-				action2->lines.insert(action2->lines.end(), it, action1->lines.end());
-			}
+			action2->lines.insert(action2->lines.end(), it, action1->lines.end());
 			return action2;
 		}
 	}
@@ -110,4 +104,44 @@ Position Remove::operator()(std::vector<std::string>& lines) {
 }
 std::shared_ptr<Action> Remove::reverse() {
 	return std::make_shared<Add>(line, col, lines);
+}
+void UndoHistory::push(const std::shared_ptr<Action>& action) {
+	// a new edit can't be followed by the ones undone before it
+	std::stack<std::shared_ptr<Action>>().swap(undos);
+	const bool merge = merge_window_open;
+	merge_window_open = true;
+	if (merge && !actions.empty()) {
+		// chain actions to avoid 1-char actions
+		std::shared_ptr<Action> new_action = Action::merge_if_adj(actions.top(), action);
+		if (new_action) {
+			actions.pop();
+			actions.push(new_action);
+			return;
+		}
+	}
+	actions.push(action);
+}
+void UndoHistory::close_merge_window() {
+	merge_window_open = false;
+}
+std::shared_ptr<Action> UndoHistory::undo() {
+	if (actions.empty()) {
+		return nullptr;
+	}
+	undos.push(actions.top()->reverse());
+	actions.pop();
+	return undos.top();
+}
+std::shared_ptr<Action> UndoHistory::redo() {
+	if (undos.empty()) {
+		return nullptr;
+	}
+	actions.push(undos.top()->reverse());
+	undos.pop();
+	return actions.top();
+}
+void UndoHistory::clear() {
+	std::stack<std::shared_ptr<Action>>().swap(actions);
+	std::stack<std::shared_ptr<Action>>().swap(undos);
+	merge_window_open = false;
 }
\ No newline at end of file
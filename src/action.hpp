@@ -1,6 +1,7 @@
 #ifndef ACTION_H
 #define ACTION_H
 #include <memory>
+#include <stack>
 #include <string>
 #include <vector>
 
@@ -15,8 +16,7 @@ class Action {
 	virtual std::shared_ptr<Action> reverse() = 0;
 	// merges action2 into action1 if adjacent
 	static std::shared_ptr<Action> merge_if_adj(const std::shared_ptr<Action>& action1,
-												const std::shared_ptr<Action>& action2,
-												const std::vector<std::string>& lines);
+												const std::shared_ptr<Action>& action2);
 
 	[[nodiscard]] Position get_end() const;
 	const size_t line;
@@ -37,4 +37,21 @@ class Remove : public Action {
 	Position operator()(std::vector<std::string>& lines) override;
 	std::shared_ptr<Action> reverse() override;
 };
+// the undo and redo stacks of a buffer, edits made in quick succession are undone together
+class UndoHistory {
+   public:
+	// records an edit, merging it into the previous one if the merge window is still open
+	void push(const std::shared_ptr<Action>& action);
+	// called once no edits were made for a while, so that the next one isn't merged
+	void close_merge_window();
+	// return the action to apply to undo/redo the last step, or nullptr if there is none
+	std::shared_ptr<Action> undo();
+	std::shared_ptr<Action> redo();
+	void clear();
+
+   private:
+	std::stack<std::shared_ptr<Action>> actions{};
+	std::stack<std::shared_ptr<Action>> undos{};
+	bool merge_window_open{false};
+};
 #endif
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "buffer.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "action.hpp"
+#include "fileio.hpp"
+#include "filewatcher.hpp"
+// number of bytes kept from the end of the file to check that it was only appended to
+const size_t disk_tail_size = 64;
+Buffer::Buffer(const std::string& filename, ThreadPool& pool)
+	: filename{filename}, watcher{filename}, pool{pool} {
+	load();
+}
+Position Buffer::apply(Action& action) {
+	const size_t old_size = lines.size();
+	Position position = action(lines);
+	// actions either only add or only remove lines after the one they start on
+	const size_t new_size = lines.size();
+	const size_t old_count = 1 + old_size - std::min(old_size, new_size);
+	const size_t new_count = 1 + new_size - std::min(old_size, new_size);
+	brackets.edit(action.line, old_count, new_count);
+	outline.edit(lines, action.line, old_count, new_count);
+	dirty = true;
+	++version;
+	return position;
+}
+void Buffer::saved(uint64_t saved_version, const FileState& state, std::string_view text) {
+	// edits made while saving still need to be saved
+	if (version == saved_version) {
+		dirty = false;
+	}
+	remember_disk_state(state, text.size(), text);
+}
+std::string Buffer::save_on_exit() {
+	if (!dirty) {
+		return "";
+	}
+	// never clobber changes made by another process, write ours next to the file instead
+	if (has_external_changes()) {
+		const std::string conflict_file = filename + ".conflict";
+		write_file(conflict_file, lines, format);
+		return conflict_file;
+	}
+	write_file(filename, lines, format);
+	return "";
+}
+void Buffer::load() {
+	std::string text;
+	lines.clear();
+	if (read_file(filename, text)) {
+		format = parse_text(text, lines, true);
+	}
+	if (lines.empty()) {
+		lines.emplace_back("");
+	}
+	brackets.clear();
+	outline.build(lines, pool);
+	++version;
+	// the file may have grown since it was read, so only trust the bytes actually read
+	remember_disk_state(FileState::of(filename), text.size(), text);
+}
+Buffer::Change Buffer::check_file() {
+	const FileState current = FileState::of(filename);
+	if (!current.exists || current == disk_state) {
+		return Change::NONE;
+	}
+	if (dirty) {
+		return Change::CONFLICT;
+	}
+	if (load_appended(current)) {
+		return Change::APPENDED;
+	}
+	load();
+	history.clear();
+	return Change::RELOADED;
+}
+bool Buffer::load_appended(const FileState& current) {
+	// only parse the new bytes if the file grew in place and the old tail is unchanged
+	if (current.inode != disk_state.inode || current.size <= disk_state.size) {
+		return false;
+	}
+	const uint64_t tail_start = disk_state.size - disk_tail.size();
+	std::string text;
+	if (!read_file(filename, text, tail_start) || text.size() <= disk_tail.size() ||
+		text.compare(0, disk_tail.size(), disk_tail) != 0) {
+		return false;
+	}
+	const std::string_view appended = std::string_view{text}.substr(disk_tail.size());
+	const size_t old_size = lines.size();
+	if (disk_state.size == 0) {
+		lines.clear();	// remove the placeholder line of an empty file
+		format = parse_text(appended, lines, true);
+		brackets.clear();
+	} else if (!append_text(appended, lines, format)) {
+		return false;
+	}
+	// the last line may have been continued
+	brackets.edit(old_size - 1, 1, lines.size() - old_size + 1);
+	outline.edit(lines, old_size - 1, 1, lines.size() - old_size + 1);
+	++version;
+	remember_disk_state(current, tail_start + text.size(), text);
+	return true;
+}
+void Buffer::remember_disk_state(const FileState& state, uint64_t size, std::string_view text) {
+	disk_state = state;
+	disk_state.size = size;
+	disk_tail = text.substr(text.size() - std::min(text.size(), disk_tail_size));
+}
+bool Buffer::has_external_changes() {
+	const FileState current = FileState::of(filename);
+	return current.exists && current != disk_state;
+}
\ No newline at end of file
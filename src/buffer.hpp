@@ -0,0 +1,67 @@
+#ifndef BUFFER_H
+#define BUFFER_H
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "action.hpp"
+#include "fileio.hpp"
+#include "filewatcher.hpp"
+#include "motion.hpp"
+#include "outline.hpp"
+#include "position.hpp"
+#include "threadpool.hpp"
+// the text of an open file and its undo history, shared by every view showing it
+class Buffer {
+   public:
+	enum class Change { NONE, APPENDED, RELOADED, CONFLICT };
+	// pool is used to index the file whenever it is loaded
+	Buffer(const std::string& filename, ThreadPool& pool);
+	Buffer(const Buffer& buffer) = delete;
+	Buffer& operator=(const Buffer& buffer) = delete;
+
+	Position apply(Action& action);
+
+	// called after text, as of saved_version, was written to the file in the background,
+	// state is what the file looked like right after the write
+	void saved(uint64_t saved_version, const FileState& state, std::string_view text);
+	// writes unsaved changes on exit, returns the file they were written to instead if the
+	// file was changed on disk, or an empty string
+	std::string save_on_exit();
+	// reloads the file if another process changed it and there are no unsaved changes
+	Change check_file();
+	bool has_external_changes();
+
+	const std::string filename;
+	std::vector<std::string> lines{};
+	FileFormat format{};
+	bool dirty{false};
+	// a background save is writing the file
+	bool saving{false};
+	// incremented on every change to lines
+	uint64_t version{0};
+	FileWatcher watcher;
+	BracketIndex brackets{};
+	OutlineIndex outline{};
+
+	UndoHistory history{};
+
+	// where the cursor was when the last view showing this buffer switched away from it
+	Position last_cursor{0, 1};
+	size_t last_window_start{0};
+
+   private:
+	ThreadPool& pool;
+	void load();
+	bool load_appended(const FileState& current);
+	// the file has size bytes as far as they were read or written, the last of them being text
+	void remember_disk_state(const FileState& state, uint64_t size, std::string_view text);
+
+	// what the file looked like the last time it was loaded or saved
+	FileState disk_state;
+	// last bytes of the file as of disk_state, used to tell appends apart from rewrites
+	std::string disk_tail;
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "config.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "utils.hpp"
+namespace {
+int parse_int(const std::string& value, int min) {
+	size_t end{0};
+	int result{0};
+	try {
+		result = std::stoi(value, &end);
+	} catch (const std::logic_error&) {
+		end = 0;
+	}
+	if (end == 0 || end != value.size() || result < min) {
+		throw std::invalid_argument{"invalid value " + value};
+	}
+	return result;
+}
+}  // namespace
+Config Config::load(const std::string& path) {
+	Config config{};
+	std::ifstream input{path};
+	size_t line_num = 0;
+	for (std::string line; std::getline(input, line);) {
+		++line_num;
+		line = trim(line.substr(0, line.find('#')));
+		if (line.empty()) {
+			continue;
+		}
+		const size_t equals = line.find('=');
+		const std::string origin = path + ":" + std::to_string(line_num);
+		try {
+			if (equals == std::string::npos) {
+				throw std::invalid_argument{"expected setting = value"};
+			}
+			const std::string name = trim(line.substr(0, equals));
+			const std::string value = trim(line.substr(equals + 1));
+			if (name.rfind("bind ", 0) == 0) {
+				config.binds.push_back(Bind{trim(name.substr(5)), value, origin});
+			} else if (name == "tab_size") {
+				config.tab_size = parse_int(value, 1);
+			} else if (name == "escape_timeout") {
+				config.escape_timeout_ms = parse_int(value, 0);
+			} else {
+				throw std::invalid_argument{"unknown setting " + name};
+			}
+		} catch (const std::invalid_argument& e) {
+			throw std::runtime_error{origin + ": " + e.what()};
+		}
+	}
+	return config;
+}
+std::string Config::default_path() {
+	const char* config_home = std::getenv("XDG_CONFIG_HOME");
+	if (config_home != nullptr && *config_home != '\0') {
+		return std::string{config_home} + "/texteditor/config";
+	}
+	const char* home = std::getenv("HOME");
+	return std::string{home != nullptr ? home : "."} + "/.config/texteditor/config";
+}
\ No newline at end of file
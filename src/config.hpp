@@ -0,0 +1,25 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+#include <string>
+#include <utility>
+#include <vector>
+// settings read from the config file, lines are either `setting = value` or `bind key = command`
+struct Config {
+	int tab_size{4};
+	// how long to wait for the rest of an escape sequence before dropping it
+	int escape_timeout_ms{100};
+	struct Bind {
+		std::string key_name;
+		std::string command;
+		// path:line of the bind, for errors
+		std::string origin;
+	};
+	// applied over the default keybinds
+	std::vector<Bind> binds{};
+
+	// returns the default config if the file doesn't exist
+	static Config load(const std::string& path);
+	// $XDG_CONFIG_HOME/texteditor/config or ~/.config/texteditor/config
+	static std::string default_path();
+};
+#endif
\ No newline at end of file
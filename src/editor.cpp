@@ -1,19 +1,26 @@
 #include "editor.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cctype>
+#include <cerrno>
 #include <chrono>
-#include <fstream>
+#include <csignal>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 #include "action.hpp"
-#include "key.hpp"
+#include "buffer.hpp"
+#include "eventloop.hpp"
+#include "fileio.hpp"
+#include "motion.hpp"
 #include "position.hpp"
-#include "utils.hpp"
+#include "view.hpp"
 #if defined(unix) || defined(__unix__) || defined(__unix)
 #include <sys/ioctl.h>
 #include <termios.h>
@@ -22,238 +29,468 @@
 #include <windows.h>
 #endif
 Editor::Editor(const std::string& filename, const std::vector<std::string>& args)
-	: filename{filename} {
-	std::ifstream input{filename};
-	for (std::string line; std::getline(input, line);) {
-		lines.push_back(line);
+	: config{Config::load(Config::default_path())} {
+	for (const auto& [key_name, command] : default_binds) {
+		bind(key_name, command);
+	}
+	for (const auto& bind : config.binds) {
+		try {
+			this->bind(bind.key_name, bind.command);
+		} catch (const std::invalid_argument& e) {
+			throw std::runtime_error{bind.origin + ": " + e.what()};
+		}
 	}
-	if (lines.empty()) {
-		lines.emplace_back("");
+	open(filename);
+	for (const auto& arg : args) {
+		if (arg == "-f" || arg == "--follow") {
+			follow = true;
+		} else {
+			open(arg);
+		}
 	}
+	views.emplace_back(buffers.front(), config.tab_size);
 }
 Editor::~Editor() {
-	save();
-	disable_raw_mode();
-	while (!actions.empty()) {
-		actions.pop();
+	// let background saves finish before writing the files again
+	loop.finish_jobs();
+	std::vector<std::string> conflict_files;
+	for (const auto& buffer : buffers) {
+		std::string conflict_file = buffer->save_on_exit();
+		if (!conflict_file.empty()) {
+			conflict_files.push_back(buffer->filename + " was changed on disk, changes saved to " +
+									 conflict_file);
+		}
 	}
+	disable_raw_mode();
 	std::cout << "\033[?1049l";	 // switch back to normal screen buffer
+	for (const auto& message : conflict_files) {
+		std::cout << message << std::endl;
+	}
 }
 void Editor::start() {
 	std::cout << "\033[?1049h";	 // switch to alternate screen buffer
 	enable_raw_mode();
 	display();
 	done = false;
+	loop.watch(EventLoop::stdin_fd, [this] { read_input(); });
+#if defined(SIGWINCH)
+	// the screen is redrawn after every event anyway
+	loop.watch_signal(SIGWINCH, [] {});
+#endif
 	while (!done) {
-		update();
+		loop.run_once();
+		if (!done) {
+			display();
+		}
 	}
 }
-inline Key Editor::get_key() {
-	return static_cast<Key>(std::cin.get());
-}
-void Editor::update() {
-	Key key = get_key();
-	auto key_handler = keybinds.keybinds.find(key);
-	if (key_handler != keybinds.keybinds.end()) {
-		(this->*(*key_handler).second)();
-	} else if (std::isprint(static_cast<int>(key)) != 0 || static_cast<char>(key) == '\t') {
-		handle_key(key);
-	} else if (key == Key::ESCAPE_START) {
-		handle_escape();
+void Editor::process_input() {
+	loop.cancel_timer(escape_timer);
+	escape_timer = 0;
+	for (const char chr : input) {
+		const auto byte = static_cast<unsigned char>(chr);
+		if (skipping_csi && !keymap.starts_sequence(byte)) {
+			// an unknown CSI sequence ends with a byte in the range @ to ~
+			skipping_csi = chr < '@' || chr > '~';
+			continue;
+		}
+		skipping_csi = false;
+		KeyMap::Match match = keymap.feed(byte);
+		if (match == KeyMap::Match::NONE && !sequence.empty() && keymap.starts_sequence(byte)) {
+			// the unfinished sequence is dropped and a new one starts at chr
+			sequence.clear();
+			match = keymap.feed(byte);
+		}
+		sequence.push_back(chr);
+		if (match != KeyMap::Match::PARTIAL) {
+			dispatch(match);
+		}
 	}
-	display();
-}
-void Editor::handle_escape() {
-	get_key();	// ignore [
-	Key key = get_key();
-	if (key != Key::MODIFIER_ARROW_START) {
-		clear_selection();
+	input.clear();
+	if (!sequence.empty() || skipping_csi) {
+		// an escape sequence is dropped if the rest of it doesn't arrive in time or isn't bound
+		escape_timer = loop.add_timer(std::chrono::milliseconds{config.escape_timeout_ms}, [this] {
+			escape_timer = 0;
+			if (!sequence.empty()) {
+				dispatch(keymap.timeout());
+			}
+			// the timed out sequence is over, so the next byte isn't part of it
+			skipping_csi = false;
+		});
+	}
+}
+void Editor::dispatch(KeyMap::Match match) {
+	++keypresses;
+	status.clear();
+	if (match == KeyMap::Match::FULL) {
+		const KeyMap::Binding& binding = keymap.matched();
+		if (!binding.keep_selection) {
+			clear_selection();
+		}
+		(this->*binding.handler)();
+	} else if (const auto chr = static_cast<unsigned char>(sequence[0]);
+			   sequence.size() == 1 && (std::isprint(chr) != 0 || chr == '\t')) {
+		handle_key(sequence[0]);
+	} else if (sequence.size() > 2 && sequence[1] == '[' &&
+			   (sequence.back() < '@' || sequence.back() > '~')) {
+		skipping_csi = true;
+	}
+	sequence.clear();
+}
+void Editor::bind(const std::string& key_name, const std::string& command) {
+	KeyMap::Binding binding{};
+	if (command != "none") {
+		auto handler = commands.find(command);
+		if (handler == commands.end()) {
+			throw std::invalid_argument{"unknown command " + command};
+		}
+		binding = handler->second;
 	}
-	auto key_handler = keybinds.escape_handlers.find(key);
-	if (key_handler != keybinds.escape_handlers.end()) {
-		(this->*(*key_handler).second)();
+	if (!keymap.bind(key_name, binding)) {
+		throw std::invalid_argument{"unknown key " + key_name};
 	}
 }
 void Editor::handle_arrow_up() {
-	if (curr_line > 0) {
-		change_line(-1);
+	View& view = current_view();
+	if (view.curr_line > 0) {
+		change_line(view.prev_visible(view.curr_line) - view.curr_line);
 		// handle differently sized lines
-		if (col > lines[curr_line].size() + 1) {
-			col = lines[curr_line].size() + 1;
+		if (view.col > lines()[view.curr_line].size() + 1) {
+			view.col = lines()[view.curr_line].size() + 1;
 		}
 	}
 }
 void Editor::handle_arrow_down() {
-	if (curr_line < lines.size() - 1) {
-		change_line(1);
-		if (col > lines[curr_line].size() + 1) {
-			col = lines[curr_line].size() + 1;
+	View& view = current_view();
+	const size_t next = view.next_visible(view.curr_line);
+	if (next < lines().size()) {
+		change_line(next - view.curr_line);
+		if (view.col > lines()[view.curr_line].size() + 1) {
+			view.col = lines()[view.curr_line].size() + 1;
 		}
 	}
 }
 void Editor::handle_arrow_left() {
-	if (col > 1) {
-		--col;
-	} else if (curr_line > 0) {
+	View& view = current_view();
+	if (view.col > 1) {
+		--view.col;
+	} else if (view.curr_line > 0) {
 		// handle moving left from the start of a line to the previous line
-		change_line(-1);
-		col = lines[curr_line].size() + 1;
+		change_line(view.prev_visible(view.curr_line) - view.curr_line);
+		view.col = lines()[view.curr_line].size() + 1;
 	}
 }
 void Editor::handle_arrow_right() {
-	if (col < lines[curr_line].size() + 1) {
-		++col;
-	} else if (curr_line < lines.size() - 1) {
+	View& view = current_view();
+	const size_t next = view.next_visible(view.curr_line);
+	if (view.col < lines()[view.curr_line].size() + 1) {
+		++view.col;
+	} else if (next < lines().size()) {
 		// handle moving right from the end of line to the following line
-		change_line(1);
-		col = 1;
-	}
-}
-void Editor::handle_modifier_arrow() {
-	// escape sequence is <ESC>[1;xy where x is 2, 5 or 6 (shift, ctrl or ctrl_shift) and
-	// y is a, b, c or d(u/d/l/r arrows)
-	get_key();	// skip ;
-	switch (get_key()) {
-		case Key::SHIFT_ARROW_START:
-			handle_shift_arrow();
-			break;
-		case Key::CTRL_ARROW_START:
-			handle_ctrl_arrow();
-			break;
-		case Key::CTRL_SHIFT_ARROW_START:
-			handle_ctrl_shift_arrow();
-			break;
-	}
-}
-void Editor::handle_shift_arrow() {
-	start_selection();
-	switch (get_key()) {
-		case Key::ARROW_UP:
-			handle_arrow_up();
-			break;
-		case Key::ARROW_DOWN:
-			handle_arrow_down();
-			break;
-		case Key::ARROW_LEFT:
-			handle_arrow_left();
-			break;
-		case Key::ARROW_RIGHT:
-			handle_arrow_right();
-			break;
-	}
-}
-void Editor::handle_ctrl_arrow() {
-	switch (get_key()) {
-		case Key::ARROW_UP:
-			handle_ctrl_arrow_up();
-			break;
-		case Key::ARROW_DOWN:
-			handle_ctrl_arrow_down();
-			break;
-		case Key::ARROW_LEFT:
-			handle_ctrl_arrow_left();
-			break;
-		case Key::ARROW_RIGHT:
-			handle_ctrl_arrow_right();
-			break;
+		change_line(next - view.curr_line);
+		view.col = 1;
 	}
 }
+void Editor::handle_shift_arrow_up() {
+	start_selection();
+	handle_arrow_up();
+}
+void Editor::handle_shift_arrow_down() {
+	start_selection();
+	handle_arrow_down();
+}
+void Editor::handle_shift_arrow_left() {
+	start_selection();
+	handle_arrow_left();
+}
+void Editor::handle_shift_arrow_right() {
+	start_selection();
+	handle_arrow_right();
+}
 void Editor::handle_ctrl_arrow_up() {
-	if (curr_line > 0) {
-		change_line(-1);
+	View& view = current_view();
+	if (view.curr_line > 0) {
+		change_line(view.prev_visible(view.curr_line) - view.curr_line);
 	}
-	col = 1;
+	view.col = 1;
 }
 void Editor::handle_ctrl_arrow_down() {
-	if (curr_line < lines.size() - 1) {
-		change_line(1);
-		col = 1;
+	View& view = current_view();
+	const size_t next = view.next_visible(view.curr_line);
+	if (next < lines().size()) {
+		change_line(next - view.curr_line);
+		view.col = 1;
 	} else {
-		col = lines[curr_line].size() + 1;
+		view.col = lines()[view.curr_line].size() + 1;
 	}
 }
 void Editor::handle_ctrl_arrow_left() {
+	View& view = current_view();
 	// if at start of line, move to end of prev line
-	if (col == 1) {
-		if (curr_line > 0) {
-			change_line(-1);
-			col = lines[curr_line].size() + 1;
+	if (view.col == 1) {
+		if (view.curr_line > 0) {
+			change_line(view.prev_visible(view.curr_line) - view.curr_line);
+			view.col = lines()[view.curr_line].size() + 1;
 		}
 		return;
 	}
 	// move to prev whitespace if found, else move to start of line
-	const std::string& line = lines[curr_line];
-	const size_t pos = line.find_last_of(" \t\n()", col - 2);
+	const std::string& line = lines()[view.curr_line];
+	const size_t pos = word_delimiters.rfind(line, view.col - 2);
 	if (pos != std::string::npos) {
-		col = pos + 1;
+		view.col = pos + 1;
 	} else {
-		col = 1;
+		view.col = 1;
 	}
 }
 void Editor::handle_ctrl_arrow_right() {
+	View& view = current_view();
 	// move to next whitespace if found, else move to end of line
-	const std::string& line = lines[curr_line];
-	const size_t pos = line.find_first_of(" \t\n()", col);
+	const std::string& line = lines()[view.curr_line];
+	const size_t pos = word_delimiters.find(line, view.col);
+	const size_t next = view.next_visible(view.curr_line);
 	if (pos != std::string::npos) {
-		col = pos + 1;
-	} else if (col < line.size() + 1) {
-		col = line.size() + 1;
-	} else if (curr_line < lines.size() - 1) {	// if at end of line, move to start of next line
-		change_line(1);
-		col = 1;
+		view.col = pos + 1;
+	} else if (view.col < line.size() + 1) {
+		view.col = line.size() + 1;
+	} else if (next < lines().size()) {  // if at end of line, move to start of next line
+		change_line(next - view.curr_line);
+		view.col = 1;
 	}
 }
-void Editor::handle_ctrl_shift_arrow() {
+void Editor::handle_ctrl_shift_arrow_up() {
+	start_selection();
+	handle_ctrl_arrow_up();
+}
+void Editor::handle_ctrl_shift_arrow_down() {
 	start_selection();
-	handle_ctrl_arrow();
+	handle_ctrl_arrow_down();
+}
+void Editor::handle_ctrl_shift_arrow_left() {
+	start_selection();
+	handle_ctrl_arrow_left();
+}
+void Editor::handle_ctrl_shift_arrow_right() {
+	start_selection();
+	handle_ctrl_arrow_right();
+}
+void Editor::paragraph_up() {
+	View& view = current_view();
+	change_line(prev_paragraph(lines(), view.curr_line) - view.curr_line);
+	view.col = 1;
+}
+void Editor::paragraph_down() {
+	View& view = current_view();
+	change_line(next_paragraph(lines(), view.curr_line) - view.curr_line);
+	view.col = 1;
+}
+void Editor::match_bracket() {
+	View& view = current_view();
+	Buffer& buffer = *view.buffer;
+	// use the bracket under the cursor, or the one just before it
+	std::optional<Position> match = buffer.brackets.match(lines(), {view.curr_line, view.col - 1});
+	if (!match && view.col > 1) {
+		match = buffer.brackets.match(lines(), {view.curr_line, view.col - 2});
+	}
+	if (match) {
+		change_line(match->line - view.curr_line);
+		view.col = match->col + 1;
+	}
+}
+void Editor::outline_next() {
+	View& view = current_view();
+	change_line(view.buffer->outline.next_sibling(view.curr_line) - view.curr_line);
+	view.col = 1;
+}
+void Editor::outline_prev() {
+	View& view = current_view();
+	change_line(view.buffer->outline.prev_sibling(view.curr_line) - view.curr_line);
+	view.col = 1;
+}
+void Editor::outline_parent() {
+	View& view = current_view();
+	change_line(view.buffer->outline.parent(view.curr_line) - view.curr_line);
+	view.col = 1;
+}
+void Editor::toggle_fold() {
+	View& view = current_view();
+	Buffer& buffer = *view.buffer;
+	if (view.unfold(view.curr_line)) {
+		return;
+	}
+	size_t line = view.curr_line;
+	size_t end = buffer.outline.region_end(line);
+	if (end == line) {
+		// a bracket opened at the end of the line and closed on a later one
+		const size_t last = lines()[line].find_last_not_of(" \t");
+		std::optional<Position> match;
+		if (last != std::string::npos) {
+			match = buffer.brackets.match(lines(), {line, last});
+		}
+		if (match && match->line > line + 1) {
+			end = match->line - 1;
+		} else {
+			// fold the region around the line instead
+			line = buffer.outline.parent(line);
+			end = buffer.outline.region_end(line);
+		}
+	}
+	view.fold(line, end);
+	view.scroll_to_cursor();
+}
+void Editor::fold_all() {
+	View& view = current_view();
+	if (view.unfold_all()) {
+		return;
+	}
+	// fold the outermost regions, skipping over them instead of looking at every line
+	OutlineIndex& outline = view.buffer->outline;
+	for (size_t line = 0; line < lines().size();) {
+		const size_t end = outline.region_end(line);
+		if (end > line) {
+			view.fold(line, end);
+			line = end + 1;
+		} else {
+			++line;
+		}
+	}
+	view.scroll_to_cursor();
 }
 void Editor::handle_backspace() {
-	if (col == 1) {
+	View& view = current_view();
+	if (view.col == 1) {
 		// handle deleting the newline
-		if (curr_line > 0) {
-			col = lines[curr_line - 1].size() + 1;
+		if (view.curr_line > 0) {
+			view.col = lines()[view.curr_line - 1].size() + 1;
 			change_line(-1);
-			perform_action(Remove(curr_line, col, std::vector<std::string>{"", ""}));
+			perform_action(Remove(view.curr_line, view.col, std::vector<std::string>{"", ""}));
 		}
 	} else {
-		char removed_char = lines[curr_line][col - 2];
-		perform_action(
-			Remove(curr_line, col - 1, std::vector<std::string>{std::string(1, removed_char)}));
+		char removed_char = lines()[view.curr_line][view.col - 2];
+		perform_action(Remove(view.curr_line, view.col - 1,
+							  std::vector<std::string>{std::string(1, removed_char)}));
 	}
 }
 void Editor::handle_enter() {
-	perform_action(Add(curr_line, col, std::vector<std::string>{"", ""}));
+	const View& view = current_view();
+	perform_action(Add(view.curr_line, view.col, std::vector<std::string>{"", ""}));
 }
-void Editor::handle_key(Key key) {
-	// std::cout << static_cast<int>(key) << " ";
-	char chr = static_cast<char>(key);
-	perform_action(Add(curr_line, col, std::vector<std::string>{std::string(1, chr)}));
+void Editor::handle_key(char chr) {
+	const View& view = current_view();
+	perform_action(Add(view.curr_line, view.col, std::vector<std::string>{std::string(1, chr)}));
 }
 void Editor::quit() {
 	done = true;
 }
 void Editor::save() {
-	std::ofstream output{filename};
-	for (const auto& line : lines) {
-		output << line << "\n";
+	const std::shared_ptr<Buffer> buffer = current_view().buffer;
+	if (buffer->saving) {
+		status = "Already saving " + buffer->filename;
+		return;
+	}
+	if (confirm_save_at != keypresses && buffer->has_external_changes()) {
+		status = "File changed on disk, press ctrl-s again to overwrite";
+		confirm_save_at = keypresses + 1;
+		return;
+	}
+	// the text is copied here, then written by a worker while editing continues
+	auto contents = std::make_shared<const std::string>(join_lines(buffer->lines, buffer->format));
+	// taken right after the write, so that later changes by other processes aren't mistaken
+	// for ours
+	auto state = std::make_shared<std::optional<FileState>>();
+	const uint64_t version = buffer->version;
+	buffer->saving = true;
+	loop.run_in_background(
+		[filename = buffer->filename, contents, state] {
+			if (write_file(filename, *contents)) {
+				*state = FileState::of(filename);
+			}
+		},
+		[this, buffer, contents, state, version] {
+			buffer->saving = false;
+			if (!*state) {
+				status = "Failed to write " + buffer->filename;
+				return;
+			}
+			buffer->saved(version, **state, *contents);
+			// events during the save were ignored
+			check_file(buffer);
+		});
+}
+void Editor::split_horizontal() {
+	split(false);
+}
+void Editor::split_vertical() {
+	split(true);
+}
+void Editor::close_view() {
+	if (views.size() > 1) {
+		layout.remove(active_view);
+		views.erase(views.begin() + active_view);
+		active_view %= views.size();
+		layout_changed = true;
+	}
+}
+void Editor::next_view() {
+	active_view = (active_view + 1) % views.size();
+}
+void Editor::next_buffer() {
+	switch_buffer(1);
+}
+void Editor::prev_buffer() {
+	switch_buffer(buffers.size() - 1);
+}
+void Editor::open(const std::string& filename) {
+	auto buffer = std::make_shared<Buffer>(filename, loop.pool);
+	buffers.push_back(buffer);
+	if (buffer->format.encoding == Encoding::BINARY) {
+		status = filename + " is not valid UTF-8, editing raw bytes";
+	}
+	loop.watch(buffer->watcher.fd(), [this, buffer] {
+		// the file is checked once our own save finishes instead
+		if (buffer->watcher.poll_changes() && !buffer->saving) {
+			check_file(buffer);
+		}
+	});
+}
+void Editor::check_file(const std::shared_ptr<Buffer>& buffer) {
+	const Buffer::Change change = buffer->check_file();
+	if (change == Buffer::Change::CONFLICT) {
+		status = buffer->filename + " changed on disk";
+	}
+	if (change != Buffer::Change::APPENDED && change != Buffer::Change::RELOADED) {
+		return;
+	}
+	for (auto& view : views) {
+		if (view.buffer != buffer) {
+			continue;
+		}
+		if (change == Buffer::Change::RELOADED) {
+			view.has_selection = false;
+			view.unfold_all();
+		}
+		if (follow) {
+			view.curr_line = buffer->lines.size() - 1;
+			view.col = buffer->lines.back().size() + 1;
+		}
+		view.clamp_cursor();
 	}
 }
 void Editor::cut() {
-	if (has_selection) {
+	View& view = current_view();
+	if (view.has_selection) {
 		copy();
-		Position selection_start = std::min(selection_mark, Position{curr_line, col});
+		Position selection_start = view.selection_bounds().first;
 		perform_action(Remove(selection_start.line, selection_start.col, clipboard));
 	}
 }
 void Editor::copy() {
-	if (has_selection) {
+	View& view = current_view();
+	if (view.has_selection) {
 		clipboard = {};
-		const std::pair<Position, Position>& selection_bounds =
-			std::minmax(selection_mark, Position{curr_line, col});
-		Position selection_start = selection_bounds.first;
-		Position selection_end = selection_bounds.second;
-		auto it = lines.begin() + selection_start.line;
-		auto end = lines.begin() + selection_end.line;
+		const auto [selection_start, selection_end] = view.selection_bounds();
+		auto it = lines().begin() + selection_start.line;
+		auto end = lines().begin() + selection_end.line;
 		if (it == end) {  // if only 1 line selection
 			clipboard.emplace_back(it->begin() + selection_start.col - 1,
 								   it->begin() + selection_end.col - 1);
@@ -275,167 +512,242 @@ void Editor::copy() {
 	}
 }
 void Editor::paste() {
-	perform_action(Add(curr_line, col, clipboard));
+	perform_action(Add(current_view().curr_line, current_view().col, clipboard));
 }
 void Editor::undo() {
-	if (!actions.empty()) {
-		std::shared_ptr<Action> action = actions.top();
-		actions.pop();
-		std::shared_ptr<Action> new_action = action->reverse();
-		execute_action(*new_action);
-		undos.push(new_action);
+	if (std::shared_ptr<Action> action = current_view().buffer->history.undo()) {
+		execute_action(*action);
 	}
 }
 void Editor::redo() {
-	if (!undos.empty()) {
-		std::shared_ptr<Action> action = undos.top();
-		undos.pop();
-		std::shared_ptr<Action> new_action = action->reverse();
-		execute_action(*new_action);
-		actions.push(new_action);
-	}
-}
-Editor::KeyBinds::KeyBinds(std::unordered_map<Key, KeyHandler> keybinds,
-						   std::unordered_map<Key, KeyHandler> escape_handlers)
-	: keybinds(std::move(keybinds)), escape_handlers(std::move(escape_handlers)) {}
-const Editor::KeyBinds Editor::KeyBinds::default_binds{
-	{{Key::CTRL_C, &Editor::copy},
-	 {Key::CTRL_Q, &Editor::quit},
-	 {Key::CTRL_V, &Editor::paste},
-	 {Key::CTRL_X, &Editor::cut},
-	 {Key::CTRL_S, &Editor::save},
-	 {Key::CTRL_Y, &Editor::redo},
-	 {Key::CTRL_Z, &Editor::undo},
-	 {Key::BACKSPACE, &Editor::handle_backspace},
-	 {Key::ENTER, &Editor::handle_enter}},
-	{{Key::ARROW_UP, &Editor::handle_arrow_up},
-	 {Key::ARROW_DOWN, &Editor::handle_arrow_down},
-	 {Key::ARROW_LEFT, &Editor::handle_arrow_left},
-	 {Key::ARROW_RIGHT, &Editor::handle_arrow_right},
-	 {Key::MODIFIER_ARROW_START, &Editor::handle_modifier_arrow}}};
+	if (std::shared_ptr<Action> action = current_view().buffer->history.redo()) {
+		execute_action(*action);
+	}
+}
+// commands that use or extend the selection, or don't move the cursor, keep the selection
+const std::unordered_map<std::string, KeyMap::Binding> Editor::commands{
+	{"copy", {&Editor::copy, true}},
+	{"cut", {&Editor::cut, true}},
+	{"paste", {&Editor::paste, false}},
+	{"quit", {&Editor::quit, true}},
+	{"save", {&Editor::save, true}},
+	{"undo", {&Editor::undo, false}},
+	{"redo", {&Editor::redo, false}},
+	{"backspace", {&Editor::handle_backspace, false}},
+	{"newline", {&Editor::handle_enter, false}},
+	{"up", {&Editor::handle_arrow_up, false}},
+	{"down", {&Editor::handle_arrow_down, false}},
+	{"left", {&Editor::handle_arrow_left, false}},
+	{"right", {&Editor::handle_arrow_right, false}},
+	{"select_up", {&Editor::handle_shift_arrow_up, true}},
+	{"select_down", {&Editor::handle_shift_arrow_down, true}},
+	{"select_left", {&Editor::handle_shift_arrow_left, true}},
+	{"select_right", {&Editor::handle_shift_arrow_right, true}},
+	{"line_start_up", {&Editor::handle_ctrl_arrow_up, false}},
+	{"line_start_down", {&Editor::handle_ctrl_arrow_down, false}},
+	{"word_left", {&Editor::handle_ctrl_arrow_left, false}},
+	{"word_right", {&Editor::handle_ctrl_arrow_right, false}},
+	{"select_line_start_up", {&Editor::handle_ctrl_shift_arrow_up, true}},
+	{"select_line_start_down", {&Editor::handle_ctrl_shift_arrow_down, true}},
+	{"select_word_left", {&Editor::handle_ctrl_shift_arrow_left, true}},
+	{"select_word_right", {&Editor::handle_ctrl_shift_arrow_right, true}},
+	{"paragraph_up", {&Editor::paragraph_up, false}},
+	{"paragraph_down", {&Editor::paragraph_down, false}},
+	{"match_bracket", {&Editor::match_bracket, false}},
+	{"outline_next", {&Editor::outline_next, false}},
+	{"outline_prev", {&Editor::outline_prev, false}},
+	{"outline_parent", {&Editor::outline_parent, false}},
+	{"toggle_fold", {&Editor::toggle_fold, true}},
+	{"fold_all", {&Editor::fold_all, true}},
+	{"split_horizontal", {&Editor::split_horizontal, true}},
+	{"split_vertical", {&Editor::split_vertical, true}},
+	{"close_view", {&Editor::close_view, true}},
+	{"next_view", {&Editor::next_view, true}},
+	{"next_buffer", {&Editor::next_buffer, false}},
+	{"prev_buffer", {&Editor::prev_buffer, false}}};
+const std::vector<std::pair<std::string, std::string>> Editor::default_binds{
+	{"ctrl-c", "copy"},
+	{"ctrl-q", "quit"},
+	{"ctrl-v", "paste"},
+	{"ctrl-x", "cut"},
+	{"ctrl-s", "save"},
+	{"ctrl-y", "redo"},
+	{"ctrl-z", "undo"},
+	{"backspace", "backspace"},
+	{"enter", "newline"},
+	{"up", "up"},
+	{"down", "down"},
+	{"left", "left"},
+	{"right", "right"},
+	{"shift-up", "select_up"},
+	{"shift-down", "select_down"},
+	{"shift-left", "select_left"},
+	{"shift-right", "select_right"},
+	{"ctrl-up", "line_start_up"},
+	{"ctrl-down", "line_start_down"},
+	{"ctrl-left", "word_left"},
+	{"ctrl-right", "word_right"},
+	{"ctrl-shift-up", "select_line_start_up"},
+	{"ctrl-shift-down", "select_line_start_down"},
+	{"ctrl-shift-left", "select_word_left"},
+	{"ctrl-shift-right", "select_word_right"},
+	{"alt-up", "paragraph_up"},
+	{"alt-down", "paragraph_down"},
+	{"ctrl-]", "match_bracket"},
+	{"alt-right", "outline_next"},
+	{"alt-left", "outline_prev"},
+	{"ctrl-u", "outline_parent"},
+	{"ctrl-t", "toggle_fold"},
+	{"ctrl-o", "fold_all"},
+	{"ctrl-b", "split_horizontal"},
+	{"ctrl-r", "split_vertical"},
+	{"ctrl-d", "close_view"},
+	{"ctrl-w", "next_view"},
+	{"ctrl-n", "next_buffer"},
+	{"ctrl-p", "prev_buffer"}};
 void Editor::display() {
-	const int tab_size = 4;	 // TODO read this from a config file
-	const std::string tab_repl(tab_size, ' ');
-	const std::string highlight_start = "\033[7m";
-	const std::string highlight_end = "\033[0m";
-	const size_t end_line = window_start + get_terminal_size().first;
+	const auto [rows, cols] = get_terminal_size();
+	// the last row is the status bar
+	const Rect screen{0, 0, std::max(rows - 1, 1), cols};
 	std::ostringstream out{};
-	out << "\033[H";  // reset cursor position
-	auto end = lines.begin() + end_line;
-	if (end > lines.end()) {
-		end = lines.end();
-	}
-	if (has_selection) {
-		const std::pair<Position, Position>& selection_bounds =
-			std::minmax(selection_mark, Position{curr_line, col});
-		Position selection_start = selection_bounds.first;
-		Position selection_end = selection_bounds.second;
-		std::vector<std::string>::iterator selection_start_line;
-		// make sure selection start/end is onscreen
-		if (selection_mark.line >= window_start) {
-			selection_start_line = lines.begin() + selection_start.line;
-		} else {
-			selection_start_line = lines.begin() + window_start;
-		}
-		std::vector<std::string>::iterator selection_end_line;
-		if (selection_end.line <= end_line) {
-			selection_end_line = lines.begin() + selection_end.line;
-		} else {
-			selection_end_line = lines.begin() + end_line;
-		}
+	if (screen != drawn_screen) {
+		out << "\033[2J";  // clear screen
+		drawn_screen = screen;
+		drawn_status.clear();
+		layout_changed = true;
+	}
+	layout.arrange(views, screen);
+	if (layout_changed) {
+		layout.draw_separators(out, screen);
+		layout_changed = false;
+	}
+	for (auto& view : views) {
+		// the view may have been resized, and moving within a line doesn't scroll
+		view.scroll_to_cursor();
+		view.draw(out);
+	}
 
-		for (auto start = lines.begin() + window_start, it{start}; it < end; ++it) {
-			if (it != start) {
-				out << '\n';
-			}
-			std::string new_str{*it};
-			if (it == selection_start_line && it == selection_end_line) {
-				// 1-line selection
-				new_str.insert(selection_start.col - 1, highlight_start);
-				if (selection_end.col + highlight_start.length() <= new_str.length()) {
-					new_str.insert(selection_end.col + highlight_start.length() - 1, highlight_end);
-				} else {
-					new_str.append(highlight_end);
-				}
-			} else if (it == selection_start_line) {
-				new_str.insert(selection_start.col - 1, highlight_start);
-			} else if (it == selection_end_line) {
-				new_str.insert(selection_end.col - 1, highlight_end);
-			}
-			out << replace_all(new_str, "\t", tab_repl);
-			out << "\033[K";  // clear to end of line
-		}
-	} else {
-		for (auto start = lines.begin() + window_start, it{start}; it < end; ++it) {
-			if (it != start) {
-				out << '\n';
-			}
-			out << replace_all(*it, "\t", tab_repl);
-			out << "\033[K";  // clear to end of line
-		}
+	const Buffer& buffer = *current_view().buffer;
+	std::string status_bar = " " + buffer.filename + (buffer.dirty ? " [+]" : "");
+	if (!status.empty()) {
+		status_bar += " | " + status;
+	}
+	status_bar.resize(cols, ' ');
+	if (status_bar != drawn_status) {
+		out << "\033[" << rows << ";1H\033[7m" << status_bar << "\033[0m";
+		drawn_status = status_bar;
 	}
-	out << "\033[J";  // clear to end of screen
 
-	const std::string& line = lines[curr_line];
-	// fix cols b/c tabs displayed as spaces in output messes up
-	size_t tabs = std::count(line.begin(), line.begin() + col - 1, '\t');
-	out << "\033[" << curr_line - window_start + 1 << ";" << col + tabs * (tab_size - 1) << "f";
-	std::cout << out.str();
+	const auto [cursor_row, cursor_col] = current_view().cursor_position();
+	out << "\033[" << cursor_row << ";" << cursor_col << "f";
+	std::cout << out.str() << std::flush;
+}
+inline View& Editor::current_view() {
+	return views[active_view];
+}
+inline std::vector<std::string>& Editor::lines() {
+	return current_view().buffer->lines;
 }
 inline void Editor::change_line(size_t offset) {
-	curr_line += offset;
+	View& view = current_view();
+	view.curr_line += offset;
+	view.reveal_cursor();
 	// adjust window_start if curr_line will be offscreen
-	if (curr_line >= window_start + get_terminal_size().first) {
-		window_start = curr_line - get_terminal_size().first + 1;
-	} else if (curr_line < window_start) {
-		window_start = curr_line;
+	view.scroll_to_cursor();
+}
+void Editor::split(bool vertical) {
+	if (!Layout::can_split(current_view().rect, vertical)) {
+		status = "View too small to split";
+		return;
 	}
+	// the new view starts out as a copy of the current one, sharing its buffer
+	View new_view{current_view()};
+	new_view.has_selection = false;
+	views.push_back(new_view);
+	layout.split(active_view, views.size() - 1, vertical);
+	active_view = views.size() - 1;
+	layout_changed = true;
+}
+void Editor::switch_buffer(size_t offset) {
+	View& view = current_view();
+	auto it = std::find(buffers.begin(), buffers.end(), view.buffer);
+	const size_t index = (it - buffers.begin() + offset) % buffers.size();
+	view.show(buffers[index]);
 }
 template <typename T>
 inline void Editor::execute_action(T&& action) {
-	Position position = action(lines);
+	View& view = current_view();
+	const size_t old_size = lines().size();
+	Position position = view.buffer->apply(action);
+	// keep the cursors of other views of the buffer on the same text
+	const size_t new_size = lines().size();
+	for (auto& other : views) {
+		if (other.buffer == view.buffer) {
+			other.edit(action.line, 1 + old_size - std::min(old_size, new_size),
+					   1 + new_size - std::min(old_size, new_size));
+		}
+		if (&other != &view && other.buffer == view.buffer) {
+			if (other.curr_line > action.line) {
+				// lines removed around the cursor collapse onto the edited line
+				other.curr_line =
+					std::max(other.curr_line + new_size, action.line + old_size) - old_size;
+			}
+			other.has_selection = false;
+			other.clamp_cursor();
+		}
+	}
 	size_t new_line = position.line;
-	col = position.col;
-	change_line(new_line - curr_line);
+	view.col = position.col;
+	change_line(new_line - view.curr_line);
 }
 template <typename T>
 void Editor::perform_action(T&& action) {
+	const std::shared_ptr<Buffer> buffer = current_view().buffer;
 	clear_selection();
-	clear_undos();
 	execute_action(action);
-	push_action(std::make_shared<T>(action));
-}
-void Editor::push_action(const std::shared_ptr<Action>& action) {
-	std::chrono::time_point<Clock> now = Clock::now();
-	std::chrono::duration<double> elapsed = now - action_timer;
-	action_timer = now;
-	if (elapsed.count() < 0.5) {
-		// chain actions to avoid 1-char actions
-		std::shared_ptr<Action> prev = actions.top();
-		std::shared_ptr<Action> new_action = Action::merge_if_adj(prev, action, lines);
-		if (new_action) {
-			actions.pop();
-			actions.push(new_action);
-			return;
+	// edits are only merged while typing into the same buffer
+	for (const auto& other : buffers) {
+		if (other != buffer) {
+			other->history.close_merge_window();
 		}
 	}
-	actions.push(action);
-}
-inline void Editor::clear_undos() {
-	std::stack<std::shared_ptr<Action>>().swap(undos);
+	buffer->history.push(std::make_shared<T>(action));
+	loop.cancel_timer(merge_timer);
+	merge_timer = loop.add_timer(std::chrono::milliseconds{500}, [this, buffer] {
+		merge_timer = 0;
+		buffer->history.close_merge_window();
+	});
 }
 inline void Editor::start_selection() {
-	if (!has_selection) {
-		selection_mark = {curr_line, col};
-		has_selection = true;
+	View& view = current_view();
+	if (!view.has_selection) {
+		view.selection_mark = {view.curr_line, view.col};
+		view.has_selection = true;
 	}
 }
 inline void Editor::clear_selection() {
-	has_selection = false;
-	selection_mark = {};
+	current_view().has_selection = false;
+	current_view().selection_mark = {};
 }
 
 #if defined(unix) || defined(__unix__) || defined(__unix)
+void Editor::read_input() {
+	std::array<char, 4096> buf{};
+	const ssize_t count = read(STDIN_FILENO, buf.data(), buf.size());
+	if (count == 0) {
+		done = true;
+		return;
+	}
+	if (count == -1) {
+		if (errno == EINTR || errno == EAGAIN) {
+			return;
+		}
+		throw std::runtime_error{"read returned -1"};
+	}
+	input.append(buf.data(), count);
+	process_input();
+}
+
 void Editor::disable_raw_mode() {
 	// from https://viewsourcecode.org/snaptoken/kilo/02.enteringRawMode.html
 	if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &orig_termios) == -1) {
@@ -468,6 +780,16 @@ std::pair<int, int> Editor::get_terminal_size() {
 }
 
 #elif defined(_WIN32)
+void Editor::read_input() {
+	const int chr = std::cin.get();
+	if (chr == EOF) {
+		done = true;
+		return;
+	}
+	input.push_back(static_cast<char>(chr));
+	process_input();
+}
+
 void Editor::disable_raw_mode() {
 	HANDLE h_stdin = GetStdHandle(STD_INPUT_HANDLE);
 	SetConsoleMode(h_stdin, orig_console_mode);
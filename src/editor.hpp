@@ -1,37 +1,39 @@
 #ifndef EDITOR_H
 #define EDITOR_H
-#include <chrono>
 #include <memory>
-#include <stack>
+#include <sstream>
 #include <string>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
 
 #include "action.hpp"
-#include "key.hpp"
+#include "buffer.hpp"
+#include "config.hpp"
+#include "eventloop.hpp"
+#include "keymap.hpp"
+#include "view.hpp"
 #if defined(unix) || defined(__unix__) || defined(__unix)
 #include <termios.h>
 #elif defined(_WIN32)
 #include <windows.h>
 #endif
-class Editor;
-using KeyHandler = void (Editor::*)();
-using Clock = std::chrono::steady_clock;
 class Editor {
    public:
 	Editor(const std::string& filename, const std::vector<std::string>& args);
 	~Editor();
-	Editor(const Editor& editor) = default;
-	Editor& operator=(const Editor& editor) = default;
-	Editor(Editor&& editor) = default;
-	Editor& operator=(Editor&& editor) = default;
-	Key get_key();
+	// copying would save the files twice
+	Editor(const Editor& editor) = delete;
+	Editor& operator=(const Editor& editor) = delete;
 
 	void start();
-	void update();
+	// reads whatever input is available without blocking
+	void read_input();
+	void process_input();
+	// handles the key sequence read so far
+	void dispatch(KeyMap::Match match);
+	void bind(const std::string& key_name, const std::string& command);
 
-	void handle_escape();
 	void handle_backspace();
 	void handle_enter();
 
@@ -40,15 +42,27 @@ class Editor {
 	void handle_arrow_left();
 	void handle_arrow_right();
 
-	void handle_modifier_arrow();
-	void handle_shift_arrow();
-	void handle_ctrl_arrow();
+	void handle_shift_arrow_up();
+	void handle_shift_arrow_down();
+	void handle_shift_arrow_left();
+	void handle_shift_arrow_right();
 	void handle_ctrl_arrow_up();
 	void handle_ctrl_arrow_down();
 	void handle_ctrl_arrow_left();
 	void handle_ctrl_arrow_right();
-	void handle_ctrl_shift_arrow();
-	void handle_key(Key key);
+	void handle_ctrl_shift_arrow_up();
+	void handle_ctrl_shift_arrow_down();
+	void handle_ctrl_shift_arrow_left();
+	void handle_ctrl_shift_arrow_right();
+	void paragraph_up();
+	void paragraph_down();
+	void match_bracket();
+	void outline_next();
+	void outline_prev();
+	void outline_parent();
+	void toggle_fold();
+	void fold_all();
+	void handle_key(char chr);
 
 	void cut();
 	void copy();
@@ -60,15 +74,26 @@ class Editor {
 	void quit();
 	void save();
 
+	void split_horizontal();
+	void split_vertical();
+	void close_view();
+	void next_view();
+	void next_buffer();
+	void prev_buffer();
+
+	void open(const std::string& filename);
+	void check_file(const std::shared_ptr<Buffer>& buffer);
 	void display();
 
+	View& current_view();
+	std::vector<std::string>& lines();
 	void change_line(size_t offset);
+	void split(bool vertical);
+	void switch_buffer(size_t offset);
 	template <typename T>
 	void execute_action(T&& action);
 	template <typename T>
 	void perform_action(T&& action);
-	void push_action(const std::shared_ptr<Action>& action);
-	void clear_undos();
 	void start_selection();
 	void clear_selection();
 	void disable_raw_mode();
@@ -76,29 +101,42 @@ class Editor {
 	std::pair<int, int> get_terminal_size();
 
    private:
-	size_t window_start{0};
-	size_t curr_line{0};
-	size_t col{1};	// 1-indexed
 	bool done{false};
-	std::string filename;
-	std::vector<std::string> lines{};
+	// waits on the terminal, the watched files, timers and background saves
+	EventLoop loop{};
+	std::vector<std::shared_ptr<Buffer>> buffers{};
+	// views share the buffers, so splitting a view doesn't copy its text
+	std::vector<View> views{};
+	Layout layout{};
+	size_t active_view{0};
+	// jump to the end of a file whenever another process appends to it
+	bool follow{false};
+
+	std::string status;
+	size_t keypresses{0};
+	size_t confirm_save_at{0};
 
-	std::stack<std::shared_ptr<Action>> actions{};
-	std::stack<std::shared_ptr<Action>> undos{};
-	std::chrono::time_point<Clock> action_timer;
+	// what was last drawn, so that only what changed is redrawn
+	Rect drawn_screen{};
+	bool layout_changed{true};
+	std::string drawn_status{};
 
 	std::vector<std::string> clipboard;
-	Position selection_mark;
-	bool has_selection{false};
-
-	struct KeyBinds {
-		KeyBinds(std::unordered_map<Key, KeyHandler> keybinds,
-				 std::unordered_map<Key, KeyHandler> escape_handlers);
-		std::unordered_map<Key, KeyHandler> keybinds;
-		std::unordered_map<Key, KeyHandler> escape_handlers;
-		const static KeyBinds default_binds;
-	};
-	KeyBinds keybinds{KeyBinds::default_binds};
+
+	Config config;
+	// command names usable in the config file
+	const static std::unordered_map<std::string, KeyMap::Binding> commands;
+	// key name and command name pairs
+	const static std::vector<std::pair<std::string, std::string>> default_binds;
+	KeyMap keymap{};
+	// bytes read but not processed yet, and the bytes of the key being matched
+	std::string input{};
+	std::string sequence{};
+	// dropping the rest of an unknown CSI sequence
+	bool skipping_csi{false};
+	EventLoop::TimerId escape_timer{0};
+	// closes the undo merge window once typing pauses
+	EventLoop::TimerId merge_timer{0};
 
 #if defined(unix) || defined(__unix__) || defined(__unix)
 	struct termios orig_termios;
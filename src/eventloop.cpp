@@ -0,0 +1,219 @@
+#include "eventloop.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+namespace {
+size_t worker_count() {
+	return std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 8);
+}
+}  // namespace
+EventLoop::TimerId EventLoop::add_timer(std::chrono::milliseconds delay, Callback callback) {
+	const TimerId timer = next_timer++;
+	timers.emplace(timer, std::pair{Clock::now() + delay, std::move(callback)});
+	arm_timer();
+	return timer;
+}
+void EventLoop::cancel_timer(TimerId timer) {
+	if (timers.erase(timer) > 0) {
+		arm_timer();
+	}
+}
+void EventLoop::run_in_background(Callback job, Callback done) {
+	{
+		std::lock_guard<std::mutex> lock{jobs_mutex};
+		++running_jobs;
+	}
+	pool.post([this, job = std::move(job), done = std::move(done)]() mutable {
+		job();
+		// finish_jobs() may return and close wake_fd as soon as the lock is released
+		std::lock_guard<std::mutex> lock{jobs_mutex};
+		completions.push_back(std::move(done));
+		--running_jobs;
+#if defined(__linux__)
+		const uint64_t one = 1;
+		(void)!write(wake_fd, &one, sizeof(one));
+#endif
+		jobs_done.notify_all();
+	});
+}
+void EventLoop::finish_jobs() {
+	{
+		std::unique_lock<std::mutex> lock{jobs_mutex};
+		jobs_done.wait(lock, [this] { return running_jobs == 0; });
+	}
+	run_completions();
+}
+void EventLoop::run_timers() {
+	const Clock::time_point now = Clock::now();
+	std::vector<Callback> due;
+	for (auto it = timers.begin(); it != timers.end();) {
+		if (it->second.first <= now) {
+			due.push_back(std::move(it->second.second));
+			it = timers.erase(it);
+		} else {
+			++it;
+		}
+	}
+	arm_timer();
+	// callbacks may add or cancel timers
+	for (auto& callback : due) {
+		callback();
+	}
+}
+void EventLoop::run_completions() {
+	std::vector<Callback> done;
+	{
+		std::lock_guard<std::mutex> lock{jobs_mutex};
+		done.swap(completions);
+	}
+	for (auto& callback : done) {
+		callback();
+	}
+}
+
+#if defined(__linux__)
+EventLoop::EventLoop() : pool{worker_count()} {
+	epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (epoll_fd == -1 || timer_fd == -1 || wake_fd == -1) {
+		throw std::runtime_error{"failed to create event loop"};
+	}
+	// the loop's own fds are told apart by fd in run_once()
+	watch(timer_fd, nullptr);
+	watch(wake_fd, nullptr);
+}
+EventLoop::~EventLoop() {
+	finish_jobs();
+	for (const int fd : {epoll_fd, timer_fd, signal_fd, wake_fd}) {
+		if (fd != -1) {
+			close(fd);
+		}
+	}
+}
+void EventLoop::watch(int fd, Callback callback) {
+	if (fd == -1) {
+		return;
+	}
+	epoll_event event{};
+	event.events = EPOLLIN;
+	event.data.fd = fd;
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) == -1) {
+		throw std::runtime_error{"epoll_ctl returned -1"};
+	}
+	watchers[fd] = std::move(callback);
+}
+void EventLoop::watch_signal(int signal, Callback callback) {
+	// signals are blocked and read from a signalfd instead of interrupting the loop
+	signal_handlers[signal] = std::move(callback);
+	sigset_t signals;
+	sigemptyset(&signals);
+	for (const auto& handler : signal_handlers) {
+		sigaddset(&signals, handler.first);
+	}
+	pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+	const bool added = signal_fd == -1;
+	signal_fd = signalfd(signal_fd, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+	if (signal_fd == -1) {
+		throw std::runtime_error{"signalfd returned -1"};
+	}
+	if (added) {
+		watch(signal_fd, nullptr);
+	}
+}
+void EventLoop::arm_timer() {
+	itimerspec spec{};
+	if (!timers.empty()) {
+		const auto next = std::min_element(
+			timers.begin(), timers.end(),
+			[](const auto& lhs, const auto& rhs) { return lhs.second.first < rhs.second.first; });
+		// a zero it_value would disarm the timer, so wait at least 1ns
+		const auto delay = std::max<Clock::duration>(next->second.first - Clock::now(),
+													 std::chrono::nanoseconds{1});
+		const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(delay);
+		spec.it_value.tv_sec = seconds.count();
+		spec.it_value.tv_nsec =
+			std::chrono::duration_cast<std::chrono::nanoseconds>(delay - seconds).count();
+	}
+	timerfd_settime(timer_fd, 0, &spec, nullptr);
+}
+void EventLoop::run_once() {
+	std::array<epoll_event, 16> events{};
+	const int count = epoll_wait(epoll_fd, events.data(), events.size(), -1);
+	if (count == -1) {
+		if (errno == EINTR) {
+			return;
+		}
+		throw std::runtime_error{"epoll_wait returned -1"};
+	}
+	for (int i = 0; i < count; ++i) {
+		const int fd = events[i].data.fd;
+		if (fd == timer_fd) {
+			uint64_t expirations;
+			(void)!read(timer_fd, &expirations, sizeof(expirations));
+			run_timers();
+		} else if (fd == wake_fd) {
+			uint64_t wakeups;
+			(void)!read(wake_fd, &wakeups, sizeof(wakeups));
+			run_completions();
+		} else if (fd == signal_fd) {
+			signalfd_siginfo info{};
+			while (read(signal_fd, &info, sizeof(info)) == sizeof(info)) {
+				auto handler = signal_handlers.find(static_cast<int>(info.ssi_signo));
+				if (handler != signal_handlers.end()) {
+					handler->second();
+				}
+			}
+		} else {
+			// callbacks may watch new fds, invalidating iterators
+			auto watcher = watchers.find(fd);
+			if (watcher != watchers.end()) {
+				watcher->second();
+			}
+		}
+	}
+}
+#else
+// without epoll, watched fds are assumed to block until ready and timers only run between them
+EventLoop::EventLoop() : pool{worker_count()} {}
+EventLoop::~EventLoop() {
+	finish_jobs();
+}
+void EventLoop::watch(int fd, Callback callback) {
+	if (fd != -1) {
+		watchers[fd] = std::move(callback);
+	}
+}
+void EventLoop::watch_signal(int signal, Callback callback) {
+	signal_handlers[signal] = std::move(callback);
+}
+void EventLoop::arm_timer() {}
+void EventLoop::run_once() {
+	run_completions();
+	run_timers();
+	// callbacks may watch new fds
+	std::vector<Callback> callbacks;
+	for (const auto& watcher : watchers) {
+		callbacks.push_back(watcher.second);
+	}
+	for (auto& callback : callbacks) {
+		callback();
+	}
+}
+#endif
\ No newline at end of file
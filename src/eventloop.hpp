@@ -0,0 +1,64 @@
+#ifndef EVENTLOOP_H
+#define EVENTLOOP_H
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "threadpool.hpp"
+using Clock = std::chrono::steady_clock;
+// single threaded loop waiting on fds, timers, signals and jobs run by a thread pool,
+// every callback is called on the thread calling run_once()
+class EventLoop {
+   public:
+	using Callback = std::function<void()>;
+	using TimerId = uint64_t;
+	// fd of standard input on every platform
+	static constexpr int stdin_fd = 0;
+	EventLoop();
+	~EventLoop();
+	EventLoop(const EventLoop& loop) = delete;
+	EventLoop& operator=(const EventLoop& loop) = delete;
+
+	// calls callback whenever fd is readable, fds of -1 are ignored
+	void watch(int fd, Callback callback);
+	// calls callback once after delay, ids are never 0
+	TimerId add_timer(std::chrono::milliseconds delay, Callback callback);
+	void cancel_timer(TimerId timer);
+	void watch_signal(int signal, Callback callback);
+	// runs job on a worker thread, then done on the loop thread
+	void run_in_background(Callback job, Callback done);
+	// waits for every job started so far and runs their done callbacks
+	void finish_jobs();
+	// blocks until something happens and handles it
+	void run_once();
+
+   private:
+	void arm_timer();
+	void run_timers();
+	void run_completions();
+
+	int epoll_fd{-1};
+	int timer_fd{-1};
+	int signal_fd{-1};
+	// written to by workers when a job is done
+	int wake_fd{-1};
+	std::unordered_map<int, Callback> watchers{};
+	std::unordered_map<TimerId, std::pair<Clock::time_point, Callback>> timers{};
+	TimerId next_timer{1};
+	std::unordered_map<int, Callback> signal_handlers{};
+
+	std::mutex jobs_mutex{};
+	std::condition_variable jobs_done{};
+	size_t running_jobs{0};
+	std::vector<Callback> completions{};
+
+   public:
+	// declared last so that its workers are joined before the members they use are destroyed
+	ThreadPool pool;
+};
+#endif
\ No newline at end of file
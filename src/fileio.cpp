@@ -0,0 +1,210 @@
+#include "fileio.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+namespace {
+const std::string_view utf8_bom{"\xEF\xBB\xBF"};
+// utf-8 decoder state, tracks the continuation bytes still expected and their valid range
+struct Utf8State {
+	int pending{0};
+	unsigned char low{0x80};
+	unsigned char high{0xBF};
+	bool valid{true};
+	void feed(unsigned char chr) {
+		if (pending > 0) {
+			if (chr < low || chr > high) {
+				valid = false;
+				pending = 0;
+			} else {
+				--pending;
+			}
+			low = 0x80;
+			high = 0xBF;
+			return;
+		}
+		if (chr < 0x80) {
+			return;
+		}
+		// the narrower ranges reject overlong encodings, surrogates and codepoints > U+10FFFF
+		if (chr >= 0xC2 && chr <= 0xDF) {
+			pending = 1;
+		} else if (chr == 0xE0) {
+			pending = 2;
+			low = 0xA0;
+		} else if (chr == 0xED) {
+			pending = 2;
+			high = 0x9F;
+		} else if (chr >= 0xE1 && chr <= 0xEF) {
+			pending = 2;
+		} else if (chr == 0xF0) {
+			pending = 3;
+			low = 0x90;
+		} else if (chr >= 0xF1 && chr <= 0xF3) {
+			pending = 3;
+		} else if (chr == 0xF4) {
+			pending = 3;
+			high = 0x8F;
+		} else {
+			valid = false;
+		}
+	}
+};
+}  // namespace
+TextScan scan_text(std::string_view text) {
+	TextScan scan{};
+	Utf8State state{};
+	const auto* data = reinterpret_cast<const unsigned char*>(text.data());
+	const size_t size = text.size();
+	size_t i = 0;
+	while (i < size) {
+#if defined(__SSE2__)
+		// 16 bytes at a time while not inside a multibyte character
+		if (state.pending == 0 && i + 16 <= size) {
+			const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+			auto newlines = static_cast<unsigned>(
+				_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))));
+			const int nuls = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_setzero_si128()));
+			const int non_ascii = _mm_movemask_epi8(chunk);
+			scan.has_nul |= nuls != 0;
+			while (newlines != 0) {
+				scan.newlines.push_back(i + __builtin_ctz(newlines));
+				newlines &= newlines - 1;
+			}
+			if (non_ascii != 0) {
+				for (size_t end = i + 16; i < end; ++i) {
+					state.feed(data[i]);
+				}
+			} else {
+				i += 16;
+			}
+			continue;
+		}
+#endif
+		const unsigned char chr = data[i];
+		if (chr == '\n') {
+			scan.newlines.push_back(i);
+		} else if (chr == '\0') {
+			scan.has_nul = true;
+		}
+		state.feed(chr);
+		++i;
+	}
+	scan.valid_utf8 = state.valid && state.pending == 0;
+	return scan;
+}
+size_t utf8_char_size(std::string_view text, size_t pos) {
+	Utf8State state{};
+	size_t end = pos;
+	do {
+		if (end >= text.size()) {
+			return 0;
+		}
+		state.feed(static_cast<unsigned char>(text[end++]));
+	} while (state.valid && state.pending > 0);
+	return state.valid ? end - pos : 0;
+}
+FileFormat parse_text(std::string_view text, std::vector<std::string>& lines, bool at_start) {
+	FileFormat format{};
+	const TextScan scan = scan_text(text);
+	if (!scan.valid_utf8 || scan.has_nul) {
+		format.encoding = Encoding::BINARY;
+	}
+	size_t start = 0;
+	if (at_start && text.substr(0, utf8_bom.size()) == utf8_bom) {
+		format.bom = true;
+		start = utf8_bom.size();
+	}
+	// only use CRLF if every line has it, otherwise the \r stays part of the line
+	const bool crlf = !scan.newlines.empty() &&
+					  std::all_of(scan.newlines.begin(), scan.newlines.end(),
+								  [&](size_t pos) { return pos > start && text[pos - 1] == '\r'; });
+	format.line_ending = crlf ? LineEnding::CRLF : LineEnding::LF;
+	const size_t eol_size = crlf ? 2 : 1;
+	lines.reserve(lines.size() + scan.newlines.size() + 1);
+	for (const size_t pos : scan.newlines) {
+		lines.emplace_back(text.substr(start, pos + 1 - eol_size - start));
+		start = pos + 1;
+	}
+	format.trailing_newline = start == text.size() && !scan.newlines.empty();
+	if (start < text.size()) {
+		lines.emplace_back(text.substr(start));
+	}
+	return format;
+}
+bool append_text(std::string_view text, std::vector<std::string>& lines, FileFormat& format) {
+	const bool had_newlines = lines.size() > 1 || (!lines.empty() && format.trailing_newline);
+	// an unterminated last line is parsed again together with the text that continues it
+	const bool continues_line = !lines.empty() && !format.trailing_newline;
+	std::string joined;
+	if (continues_line) {
+		joined = lines.back();
+		joined.append(text);
+		text = joined;
+	}
+	std::vector<std::string> new_lines;
+	const FileFormat new_format = parse_text(text, new_lines, false);
+	const bool has_newlines = new_format.trailing_newline || new_lines.size() > 1;
+	if (had_newlines && has_newlines && new_format.line_ending != format.line_ending) {
+		return false;
+	}
+	if (continues_line) {
+		lines.pop_back();
+	}
+	if (!had_newlines && has_newlines) {
+		format.line_ending = new_format.line_ending;
+	}
+	if (new_format.encoding == Encoding::BINARY) {
+		format.encoding = Encoding::BINARY;
+	}
+	format.trailing_newline = new_format.trailing_newline;
+	lines.insert(lines.end(), std::make_move_iterator(new_lines.begin()),
+				 std::make_move_iterator(new_lines.end()));
+	return true;
+}
+bool read_file(const std::string& path, std::string& contents, uint64_t offset) {
+	std::ifstream input{path, std::ios::binary | std::ios::ate};
+	if (!input) {
+		return false;
+	}
+	const auto end = static_cast<uint64_t>(input.tellg());
+	contents.resize(end > offset ? end - offset : 0);
+	input.seekg(static_cast<std::streamoff>(offset));
+	input.read(contents.data(), static_cast<std::streamsize>(contents.size()));
+	contents.resize(input.gcount());
+	return true;
+}
+std::string join_lines(const std::vector<std::string>& lines, const FileFormat& format) {
+	const std::string_view eol = format.line_ending == LineEnding::CRLF ? "\r\n" : "\n";
+	size_t size = format.bom ? utf8_bom.size() : 0;
+	for (const auto& line : lines) {
+		size += line.size() + eol.size();
+	}
+	std::string contents;
+	contents.reserve(size);
+	if (format.bom) {
+		contents.append(utf8_bom);
+	}
+	for (auto it = lines.begin(); it < lines.end(); ++it) {
+		contents.append(*it);
+		if (it < lines.end() - 1 || format.trailing_newline) {
+			contents.append(eol);
+		}
+	}
+	return contents;
+}
+bool write_file(const std::string& path, std::string_view contents) {
+	std::ofstream output{path, std::ios::binary | std::ios::trunc};
+	output.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+	return output.good();
+}
+bool write_file(const std::string& path, const std::vector<std::string>& lines,
+				const FileFormat& format) {
+	return write_file(path, join_lines(lines, format));
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef FILEIO_H
+#define FILEIO_H
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+enum class LineEnding { LF, CRLF };
+enum class Encoding { UTF8, BINARY };
+// how a file was laid out on disk, so that saving it reproduces the same bytes
+struct FileFormat {
+	LineEnding line_ending{LineEnding::LF};
+	Encoding encoding{Encoding::UTF8};
+	bool bom{false};
+	bool trailing_newline{true};
+};
+struct TextScan {
+	std::vector<size_t> newlines;
+	bool valid_utf8{true};
+	bool has_nul{false};
+};
+// validates utf-8 and indexes newlines in a single pass
+TextScan scan_text(std::string_view text);
+// length of the valid utf-8 char starting at pos, or 0 if the bytes there aren't one
+size_t utf8_char_size(std::string_view text, size_t pos);
+// appends the lines of text to lines and returns the detected format
+FileFormat parse_text(std::string_view text, std::vector<std::string>& lines, bool at_start);
+// appends text to the end of a file already split into lines,
+// returns false if its line endings don't match the rest of the file
+bool append_text(std::string_view text, std::vector<std::string>& lines, FileFormat& format);
+// reads from offset to the end of the file, returns false if it can't be opened
+bool read_file(const std::string& path, std::string& contents, uint64_t offset = 0);
+// the contents of a file with these lines
+std::string join_lines(const std::vector<std::string>& lines, const FileFormat& format);
+bool write_file(const std::string& path, std::string_view contents);
+bool write_file(const std::string& path, const std::vector<std::string>& lines,
+				const FileFormat& format);
+#endif
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "filewatcher.hpp"
+
+#include <string>
+
+#include <sys/stat.h>
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+FileState FileState::of(const std::string& filename) {
+	FileState state{};
+	struct stat info {};
+	if (stat(filename.c_str(), &info) != 0) {
+		return state;
+	}
+	state.exists = true;
+	state.inode = info.st_ino;
+	state.size = info.st_size;
+#if defined(__linux__)
+	state.mtime_ns = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#else
+	state.mtime_ns = static_cast<int64_t>(info.st_mtime) * 1000000000;
+#endif
+	return state;
+}
+
+#if defined(__linux__)
+FileWatcher::FileWatcher(const std::string& filename) {
+	const size_t slash = filename.find_last_of('/');
+	const std::string dir = slash == std::string::npos ? "." : filename.substr(0, slash + 1);
+	basename = slash == std::string::npos ? filename : filename.substr(slash + 1);
+	inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotify_fd == -1) {
+		return;
+	}
+	const uint32_t mask = IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_TO |
+						  IN_MOVED_FROM | IN_ATTRIB;
+	if (inotify_add_watch(inotify_fd, dir.c_str(), mask) == -1) {
+		close(inotify_fd);
+		inotify_fd = -1;
+	}
+}
+FileWatcher::~FileWatcher() {
+	if (inotify_fd != -1) {
+		close(inotify_fd);
+	}
+}
+int FileWatcher::fd() const {
+	return inotify_fd;
+}
+bool FileWatcher::poll_changes() {
+	if (inotify_fd == -1) {
+		return false;
+	}
+	bool changed = false;
+	alignas(inotify_event) char buf[4096];
+	ssize_t len;
+	while ((len = read(inotify_fd, buf, sizeof(buf))) > 0) {
+		for (char* ptr = buf; ptr < buf + len;) {
+			const auto* event = reinterpret_cast<const inotify_event*>(ptr);
+			if (event->len > 0 && basename == event->name) {
+				changed = true;
+			}
+			ptr += sizeof(inotify_event) + event->len;
+		}
+	}
+	return changed;
+}
+#else
+FileWatcher::FileWatcher(const std::string& filename) : basename{filename} {}
+FileWatcher::~FileWatcher() = default;
+int FileWatcher::fd() const {
+	return inotify_fd;
+}
+bool FileWatcher::poll_changes() {
+	return false;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+#include <cstdint>
+#include <string>
+// identity of the file on disk, used to detect changes made by other processes
+struct FileState {
+	bool exists{false};
+	uint64_t inode{0};
+	uint64_t size{0};
+	int64_t mtime_ns{0};
+	static FileState of(const std::string& filename);
+};
+inline bool operator==(const FileState& lhs, const FileState& rhs) {
+	return lhs.exists == rhs.exists && lhs.inode == rhs.inode && lhs.size == rhs.size &&
+		   lhs.mtime_ns == rhs.mtime_ns;
+}
+inline bool operator!=(const FileState& lhs, const FileState& rhs) {
+	return !operator==(lhs, rhs);
+}
+// watches the directory containing a file so that rewrites via rename are also caught
+class FileWatcher {
+   public:
+	explicit FileWatcher(const std::string& filename);
+	~FileWatcher();
+	FileWatcher(const FileWatcher& watcher) = delete;
+	FileWatcher& operator=(const FileWatcher& watcher) = delete;
+	// -1 if watching isn't supported
+	[[nodiscard]] int fd() const;
+	// drains pending events, returns true if any of them concern the watched file
+	bool poll_changes();
+
+   private:
+	std::string basename;
+	int inotify_fd{-1};
+};
+#endif
\ No newline at end of file
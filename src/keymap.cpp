@@ -0,0 +1,116 @@
+#include "keymap.hpp"
+
+#include <string_view>
+#include <utility>
+#include <vector>
+const std::vector<std::pair<std::string_view, std::string_view>> KeyMap::key_names{
+	{"ctrl-a", "\x01"},
+	{"ctrl-b", "\x02"},
+	{"ctrl-c", "\x03"},
+	{"ctrl-d", "\x04"},
+	{"ctrl-e", "\x05"},
+	{"ctrl-f", "\x06"},
+	{"ctrl-g", "\x07"},
+	{"ctrl-h", "\x08"},
+	{"ctrl-k", "\x0b"},
+	{"ctrl-l", "\x0c"},
+	{"ctrl-n", "\x0e"},
+	{"ctrl-o", "\x0f"},
+	{"ctrl-p", "\x10"},
+	{"ctrl-q", "\x11"},
+	{"ctrl-r", "\x12"},
+	{"ctrl-s", "\x13"},
+	{"ctrl-t", "\x14"},
+	{"ctrl-u", "\x15"},
+	{"ctrl-v", "\x16"},
+	{"ctrl-w", "\x17"},
+	{"ctrl-x", "\x18"},
+	{"ctrl-y", "\x19"},
+	{"ctrl-z", "\x1a"},
+	{"ctrl-]", "\x1d"},
+	{"tab", "\t"},
+	{"enter", "\r"},
+	{"backspace", "\x7f"},
+	// ANSI escape codes, with the variants sent in application cursor mode
+	{"up", "\033[A"},
+	{"up", "\033OA"},
+	{"down", "\033[B"},
+	{"down", "\033OB"},
+	{"right", "\033[C"},
+	{"right", "\033OC"},
+	{"left", "\033[D"},
+	{"left", "\033OD"},
+	{"home", "\033[H"},
+	{"home", "\033OH"},
+	{"home", "\033[1~"},
+	{"end", "\033[F"},
+	{"end", "\033OF"},
+	{"end", "\033[4~"},
+	{"insert", "\033[2~"},
+	{"delete", "\033[3~"},
+	{"page-up", "\033[5~"},
+	{"page-down", "\033[6~"},
+	// modified arrows are <ESC>[1;xy where x is the modifier and y is the arrow
+	{"shift-up", "\033[1;2A"},
+	{"shift-down", "\033[1;2B"},
+	{"shift-right", "\033[1;2C"},
+	{"shift-left", "\033[1;2D"},
+	{"alt-up", "\033[1;3A"},
+	{"alt-down", "\033[1;3B"},
+	{"alt-right", "\033[1;3C"},
+	{"alt-left", "\033[1;3D"},
+	{"ctrl-up", "\033[1;5A"},
+	{"ctrl-down", "\033[1;5B"},
+	{"ctrl-right", "\033[1;5C"},
+	{"ctrl-left", "\033[1;5D"},
+	{"ctrl-shift-up", "\033[1;6A"},
+	{"ctrl-shift-down", "\033[1;6B"},
+	{"ctrl-shift-right", "\033[1;6C"},
+	{"ctrl-shift-left", "\033[1;6D"}};
+bool KeyMap::bind(std::string_view key_name, Binding binding) {
+	bool found = false;
+	for (const auto& [name, sequence] : key_names) {
+		if (name == key_name) {
+			bind_sequence(sequence, binding);
+			found = true;
+		}
+	}
+	return found;
+}
+void KeyMap::bind_sequence(std::string_view sequence, Binding binding) {
+	uint16_t node = 0;
+	for (const char chr : sequence) {
+		const auto byte = static_cast<unsigned char>(chr);
+		if (nodes[node].next[byte] == 0) {
+			nodes[node].next[byte] = static_cast<uint16_t>(nodes.size());
+			nodes[node].has_children = true;
+			nodes.emplace_back();
+		}
+		node = nodes[node].next[byte];
+	}
+	nodes[node].binding = binding;
+}
+KeyMap::Match KeyMap::feed(unsigned char byte) {
+	const uint16_t next = byte < 128 ? nodes[state].next[byte] : 0;
+	if (next == 0) {
+		state = 0;
+		return Match::NONE;
+	}
+	state = next;
+	if (nodes[state].has_children) {
+		return Match::PARTIAL;
+	}
+	return timeout();
+}
+bool KeyMap::starts_sequence(unsigned char byte) const {
+	const uint16_t next = byte < 128 ? nodes[0].next[byte] : 0;
+	return next != 0 && nodes[next].has_children;
+}
+KeyMap::Match KeyMap::timeout() {
+	last_match = state;
+	state = 0;
+	return nodes[last_match].binding.handler != nullptr ? Match::FULL : Match::NONE;
+}
+const KeyMap::Binding& KeyMap::matched() const {
+	return nodes[last_match].binding;
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#ifndef KEYMAP_H
+#define KEYMAP_H
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+class Editor;
+using KeyHandler = void (Editor::*)();
+// state machine matching the byte sequences sent by keys, one byte at a time
+class KeyMap {
+   public:
+	enum class Match { NONE, PARTIAL, FULL };
+	struct Binding {
+		KeyHandler handler{nullptr};
+		// whether the selection survives the command
+		bool keep_selection{false};
+	};
+	// the byte sequences sent by each key name, a name may have several
+	static const std::vector<std::pair<std::string_view, std::string_view>> key_names;
+
+	// binds every sequence of the key name, returns false if the name is unknown
+	bool bind(std::string_view key_name, Binding binding);
+	void bind_sequence(std::string_view sequence, Binding binding);
+	Match feed(unsigned char byte);
+	// whether byte begins a longer sequence, such as a second escape ending an unfinished one
+	[[nodiscard]] bool starts_sequence(unsigned char byte) const;
+	// called when the rest of a partial sequence didn't arrive in time
+	Match timeout();
+	// valid after feed() or timeout() returned FULL
+	[[nodiscard]] const Binding& matched() const;
+
+   private:
+	struct Node {
+		// index of the child node for each byte, 0 if none
+		std::array<uint16_t, 128> next{};
+		bool has_children{false};
+		Binding binding{};
+	};
+	std::vector<Node> nodes{1};
+	uint16_t state{0};
+	uint16_t last_match{0};
+};
+#endif
\ No newline at end of file
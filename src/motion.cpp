@@ -0,0 +1,242 @@
+#include "motion.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "position.hpp"
+#include "summaries.hpp"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+namespace {
+const CharSet brackets{"()[]{}"};
+// index into BracketIndex::Summary::kinds
+size_t bracket_kind(char chr) {
+	switch (chr) {
+		case '(':
+		case ')':
+			return 0;
+		case '[':
+		case ']':
+			return 1;
+		default:
+			return 2;
+	}
+}
+bool is_opening(char chr) {
+	return chr == '(' || chr == '[' || chr == '{';
+}
+}  // namespace
+const CharSet word_delimiters{" \t\n()"};
+CharSet::CharSet(std::string_view chars) : chars{chars} {
+	for (const char chr : chars) {
+		table[static_cast<unsigned char>(chr)] = true;
+	}
+}
+size_t CharSet::find(std::string_view text, size_t pos) const {
+#if defined(__SSE2__)
+	for (; pos + 16 <= text.size(); pos += 16) {
+		const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + pos));
+		int mask = 0;
+		for (const char chr : chars) {
+			mask |= _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(chr)));
+		}
+		if (mask != 0) {
+			return pos + __builtin_ctz(mask);
+		}
+	}
+#endif
+	for (; pos < text.size(); ++pos) {
+		if (contains(text[pos])) {
+			return pos;
+		}
+	}
+	return std::string_view::npos;
+}
+size_t CharSet::rfind(std::string_view text, size_t pos) const {
+	if (text.empty()) {
+		return std::string_view::npos;
+	}
+	// search [0, end)
+	size_t end = std::min(pos, text.size() - 1) + 1;
+#if defined(__SSE2__)
+	for (; end >= 16; end -= 16) {
+		const __m128i chunk =
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + end - 16));
+		int mask = 0;
+		for (const char chr : chars) {
+			mask |= _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(chr)));
+		}
+		if (mask != 0) {
+			return end - 16 + (31 - __builtin_clz(mask));
+		}
+	}
+#endif
+	while (end > 0) {
+		--end;
+		if (contains(text[end])) {
+			return end;
+		}
+	}
+	return std::string_view::npos;
+}
+bool CharSet::contains(char chr) const {
+	return table[static_cast<unsigned char>(chr)];
+}
+bool is_blank(const std::string& line) {
+	return line.find_first_not_of(" \t") == std::string::npos;
+}
+size_t next_paragraph(const std::vector<std::string>& lines, size_t line) {
+	size_t next = line + 1;
+	while (next < lines.size() && is_blank(lines[next])) {
+		++next;
+	}
+	while (next < lines.size() && !is_blank(lines[next])) {
+		++next;
+	}
+	return std::min(next, lines.size() - 1);
+}
+size_t prev_paragraph(const std::vector<std::string>& lines, size_t line) {
+	// prev is one past the line being checked
+	size_t prev = line;
+	while (prev > 0 && is_blank(lines[prev - 1])) {
+		--prev;
+	}
+	while (prev > 0 && !is_blank(lines[prev - 1])) {
+		--prev;
+	}
+	return prev > 0 ? prev - 1 : 0;
+}
+void BracketIndex::edit(size_t line, size_t old_count, size_t new_count) {
+	// blocks past the end are added back by resize()
+	splice_summaries(line_summaries, block_summaries, block_size, line, old_count, new_count,
+					 Summary{});
+}
+void BracketIndex::clear() {
+	line_summaries.clear();
+	block_summaries.clear();
+}
+void BracketIndex::resize(size_t size) {
+	line_summaries.resize(size);
+	block_summaries.resize((size + block_size - 1) / block_size);
+}
+const BracketIndex::Depth& BracketIndex::line_depth(const std::vector<std::string>& lines,
+													size_t line, size_t kind) {
+	Summary& summary = line_summaries[line];
+	if (!summary.valid) {
+		summary = Summary{};
+		summary.valid = true;
+		const std::string& text = lines[line];
+		for (size_t pos = brackets.find(text, 0); pos != std::string::npos;
+			 pos = brackets.find(text, pos + 1)) {
+			Depth& depth = summary.kinds[bracket_kind(text[pos])];
+			depth.delta += is_opening(text[pos]) ? 1 : -1;
+			depth.min_prefix = std::min(depth.min_prefix, depth.delta);
+		}
+	}
+	return summary.kinds[kind];
+}
+const BracketIndex::Depth& BracketIndex::block_depth(const std::vector<std::string>& lines,
+													 size_t block, size_t kind) {
+	Summary& summary = block_summaries[block];
+	if (!summary.valid) {
+		summary = Summary{};
+		summary.valid = true;
+		const size_t end = std::min((block + 1) * block_size, lines.size());
+		for (size_t line = block * block_size; line < end; ++line) {
+			for (size_t i = 0; i < summary.kinds.size(); ++i) {
+				const Depth& depth = line_depth(lines, line, i);
+				Depth& total = summary.kinds[i];
+				total.min_prefix = std::min(total.min_prefix, total.delta + depth.min_prefix);
+				total.delta += depth.delta;
+			}
+		}
+	}
+	return summary.kinds[kind];
+}
+std::optional<Position> BracketIndex::match(const std::vector<std::string>& lines,
+											Position pos) {
+	const std::string& start_line = lines[pos.line];
+	if (pos.col >= start_line.size() || !brackets.contains(start_line[pos.col])) {
+		return std::nullopt;
+	}
+	resize(lines.size());
+	const size_t kind = bracket_kind(start_line[pos.col]);
+	// depth counts the unmatched brackets, starting with the one at pos
+	int32_t depth = 0;
+	// returns the col in line where depth reaches 0
+	auto scan_forward = [&](const std::string& line, size_t from) -> std::optional<size_t> {
+		for (size_t col = brackets.find(line, from); col != std::string::npos;
+			 col = brackets.find(line, col + 1)) {
+			if (bracket_kind(line[col]) == kind) {
+				depth += is_opening(line[col]) ? 1 : -1;
+				if (depth == 0) {
+					return col;
+				}
+			}
+		}
+		return std::nullopt;
+	};
+	auto scan_backward = [&](const std::string& line, size_t from) -> std::optional<size_t> {
+		for (size_t col = brackets.rfind(line, from); col != std::string::npos;
+			 col = col > 0 ? brackets.rfind(line, col - 1) : std::string::npos) {
+			if (bracket_kind(line[col]) == kind) {
+				depth += is_opening(line[col]) ? -1 : 1;
+				if (depth == 0) {
+					return col;
+				}
+			}
+		}
+		return std::nullopt;
+	};
+
+	if (is_opening(start_line[pos.col])) {
+		if (auto col = scan_forward(start_line, pos.col)) {
+			return Position{pos.line, *col};
+		}
+		for (size_t line = pos.line + 1; line < lines.size();) {
+			if (line % block_size == 0 && line + block_size <= lines.size()) {
+				const Depth& block = block_depth(lines, line / block_size, kind);
+				if (depth + block.min_prefix > 0) {
+					depth += block.delta;
+					line += block_size;
+					continue;
+				}
+			}
+			const Depth& line_depth = this->line_depth(lines, line, kind);
+			if (depth + line_depth.min_prefix > 0) {
+				depth += line_depth.delta;
+			} else if (auto col = scan_forward(lines[line], 0)) {
+				return Position{line, *col};
+			}
+			++line;
+		}
+	} else {
+		if (auto col = scan_backward(start_line, pos.col)) {
+			return Position{pos.line, *col};
+		}
+		// end is one past the line being checked
+		for (size_t end = pos.line; end > 0;) {
+			if (end % block_size == 0) {
+				const Depth& block = block_depth(lines, end / block_size - 1, kind);
+				if (depth + block.min_prefix - block.delta > 0) {
+					depth -= block.delta;
+					end -= block_size;
+					continue;
+				}
+			}
+			const size_t line = end - 1;
+			const Depth& line_depth = this->line_depth(lines, line, kind);
+			if (depth + line_depth.min_prefix - line_depth.delta > 0) {
+				depth -= line_depth.delta;
+			} else if (auto col = scan_backward(lines[line], lines[line].size())) {
+				return Position{line, *col};
+			}
+			--end;
+		}
+	}
+	return std::nullopt;
+}
\ No newline at end of file
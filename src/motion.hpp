@@ -0,0 +1,62 @@
+#ifndef MOTION_H
+#define MOTION_H
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "position.hpp"
+// set of ascii chars, searched for 16 bytes at a time
+class CharSet {
+   public:
+	explicit CharSet(std::string_view chars);
+	// index of the first char in the set at or after pos, or npos
+	[[nodiscard]] size_t find(std::string_view text, size_t pos) const;
+	// index of the last char in the set at or before pos, or npos
+	[[nodiscard]] size_t rfind(std::string_view text, size_t pos) const;
+	[[nodiscard]] bool contains(char chr) const;
+
+   private:
+	std::string chars;
+	std::array<bool, 256> table{};
+};
+extern const CharSet word_delimiters;
+
+bool is_blank(const std::string& line);
+// the next/previous blank line, or the last/first line if there is none
+size_t next_paragraph(const std::vector<std::string>& lines, size_t line);
+size_t prev_paragraph(const std::vector<std::string>& lines, size_t line);
+
+// bracket depth summaries of each line and of blocks of lines, built lazily, so that finding
+// a matching bracket skips over lines and blocks that can't contain it
+class BracketIndex {
+   public:
+	// lines [line, line + old_count) were replaced by new_count lines
+	void edit(size_t line, size_t old_count, size_t new_count);
+	void clear();
+	// position of the bracket matching the one at pos (0-indexed col), if any
+	std::optional<Position> match(const std::vector<std::string>& lines, Position pos);
+
+   private:
+	// for one kind of bracket, opening brackets count +1 and closing brackets -1
+	struct Depth {
+		int32_t delta{0};
+		// lowest running total, the match is inside if depth + min_prefix <= 0
+		// going backwards the lowest running total is min_prefix - delta
+		int32_t min_prefix{0};
+	};
+	struct Summary {
+		std::array<Depth, 3> kinds{};
+		bool valid{false};
+	};
+	static constexpr size_t block_size = 1024;
+	const Depth& line_depth(const std::vector<std::string>& lines, size_t line, size_t kind);
+	const Depth& block_depth(const std::vector<std::string>& lines, size_t block, size_t kind);
+	void resize(size_t size);
+
+	std::vector<Summary> line_summaries{};
+	std::vector<Summary> block_summaries{};
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "outline.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "summaries.hpp"
+#include "threadpool.hpp"
+namespace {
+// smaller files are indexed on the calling thread
+const size_t parallel_threshold = 1 << 16;
+}  // namespace
+int32_t OutlineIndex::indent_of(const std::string& line) {
+	// tabs and spaces both count as one
+	const size_t indent = line.find_first_not_of(" \t");
+	if (indent == std::string::npos) {
+		return blank;
+	}
+	return static_cast<int32_t>(std::min<size_t>(indent, blank - 1));
+}
+void OutlineIndex::index(const std::vector<std::string>& lines, size_t begin, size_t end) {
+	for (size_t line = begin; line < end; ++line) {
+		indents[line] = indent_of(lines[line]);
+		Block& block = blocks[line / block_size];
+		block.min_indent = std::min(block.min_indent, indents[line]);
+	}
+	for (size_t block = begin / block_size; block * block_size < end; ++block) {
+		blocks[block].valid = true;
+	}
+}
+void OutlineIndex::build(const std::vector<std::string>& lines, ThreadPool& pool) {
+	indents.assign(lines.size(), blank);
+	blocks.assign((lines.size() + block_size - 1) / block_size, Block{});
+	if (lines.size() < parallel_threshold || pool.size() < 2) {
+		index(lines, 0, lines.size());
+		return;
+	}
+	// chunks are made of whole blocks so that no two workers write to the same block
+	const size_t chunk = (blocks.size() + pool.size() - 1) / pool.size() * block_size;
+	std::mutex mutex;
+	std::condition_variable done;
+	size_t remaining = (lines.size() + chunk - 1) / chunk;
+	for (size_t begin = 0; begin < lines.size(); begin += chunk) {
+		const size_t end = std::min(begin + chunk, lines.size());
+		pool.post([&, begin, end] {
+			index(lines, begin, end);
+			// notified while locked, so that build can't return before the worker is done with done
+			std::lock_guard<std::mutex> lock{mutex};
+			--remaining;
+			done.notify_one();
+		});
+	}
+	std::unique_lock<std::mutex> lock{mutex};
+	done.wait(lock, [&] { return remaining == 0; });
+}
+void OutlineIndex::edit(const std::vector<std::string>& lines, size_t line, size_t old_count,
+						size_t new_count) {
+	if (!splice_summaries(indents, blocks, block_size, line, old_count, new_count, blank)) {
+		return;
+	}
+	for (size_t i = line; i < line + new_count; ++i) {
+		indents[i] = indent_of(lines[i]);
+	}
+	blocks.resize((indents.size() + block_size - 1) / block_size);
+}
+int32_t OutlineIndex::block_indent(size_t block) {
+	Block& summary = blocks[block];
+	if (!summary.valid) {
+		const auto begin = indents.begin() + block * block_size;
+		const auto end = indents.begin() + std::min((block + 1) * block_size, indents.size());
+		summary.min_indent = *std::min_element(begin, end);
+		summary.valid = true;
+	}
+	return summary.min_indent;
+}
+size_t OutlineIndex::find_forward(size_t from, int32_t max_indent) {
+	for (size_t line = from; line < indents.size();) {
+		if (line % block_size == 0 && block_indent(line / block_size) > max_indent) {
+			line += block_size;
+			continue;
+		}
+		if (indents[line] <= max_indent) {
+			return line;
+		}
+		++line;
+	}
+	return indents.size();
+}
+size_t OutlineIndex::find_backward(size_t end, int32_t max_indent) {
+	for (size_t line = end; line > 0;) {
+		if (line % block_size == 0 && block_indent(line / block_size - 1) > max_indent) {
+			line -= block_size;
+			continue;
+		}
+		--line;
+		if (indents[line] <= max_indent) {
+			return line;
+		}
+	}
+	return end;
+}
+size_t OutlineIndex::region_end(size_t line) {
+	if (line >= indents.size() || indents[line] == blank) {
+		return line;
+	}
+	size_t end = find_forward(line + 1, indents[line]);
+	// the blank lines before the next region stay visible
+	while (end > line + 1 && indents[end - 1] == blank) {
+		--end;
+	}
+	return end - 1;
+}
+size_t OutlineIndex::next_sibling(size_t line) {
+	if (line >= indents.size()) {
+		return line;
+	}
+	// from a blank line, go to the next non-blank one
+	const size_t next = find_forward(line + 1, std::min(indents[line], blank - 1));
+	return next < indents.size() ? next : line;
+}
+size_t OutlineIndex::prev_sibling(size_t line) {
+	if (line >= indents.size()) {
+		return line;
+	}
+	return find_backward(line, std::min(indents[line], blank - 1));
+}
+size_t OutlineIndex::parent(size_t line) {
+	if (line >= indents.size() || indents[line] == 0) {
+		return line;
+	}
+	return find_backward(line, std::min(indents[line], blank - 1) - 1);
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef OUTLINE_H
+#define OUTLINE_H
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "threadpool.hpp"
+// indentation of every line and the shallowest indentation of blocks of lines, so that the end
+// of an indented region is found by skipping over blocks instead of lines
+class OutlineIndex {
+   public:
+	// indexes the lines in parallel chunks
+	void build(const std::vector<std::string>& lines, ThreadPool& pool);
+	// indexes the new_count lines that replaced lines [line, line + old_count)
+	void edit(const std::vector<std::string>& lines, size_t line, size_t old_count,
+			  size_t new_count);
+	// last line of the region indented deeper than line, or line if there is none,
+	// blank lines at the end of the region are left out
+	size_t region_end(size_t line);
+	// the next/previous non-blank line indented at most as deep as line, or line if there is none
+	size_t next_sibling(size_t line);
+	size_t prev_sibling(size_t line);
+	// the previous line indented less deeply than line, or line if there is none
+	size_t parent(size_t line);
+
+   private:
+	static constexpr size_t block_size = 1024;
+	// indentation of blank lines, so that they never end a region
+	static constexpr int32_t blank = INT32_MAX;
+	struct Block {
+		int32_t min_indent{blank};
+		bool valid{false};
+	};
+	static int32_t indent_of(const std::string& line);
+	void index(const std::vector<std::string>& lines, size_t begin, size_t end);
+	int32_t block_indent(size_t block);
+	// first line in [from, size) indented at most max_indent, or size
+	size_t find_forward(size_t from, int32_t max_indent);
+	// last line in [0, end) indented at most max_indent, or end
+	size_t find_backward(size_t end, int32_t max_indent);
+
+	std::vector<int32_t> indents{};
+	std::vector<Block> blocks{};
+};
+#endif
\ No newline at end of file
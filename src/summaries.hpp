@@ -0,0 +1,31 @@
+#ifndef SUMMARIES_H
+#define SUMMARIES_H
+#include <algorithm>
+#include <vector>
+// updates a summary per line and a summary per block of block_size lines after lines
+// [line, line + old_count) were replaced by new_count lines, the new lines get fresh summaries and
+// the blocks they are in are marked invalid, returns false if line is past the summarized lines
+template <typename LineSummary, typename BlockSummary>
+bool splice_summaries(std::vector<LineSummary>& lines, std::vector<BlockSummary>& blocks,
+					  size_t block_size, size_t line, size_t old_count, size_t new_count,
+					  const LineSummary& fresh) {
+	if (line > lines.size()) {
+		return false;
+	}
+	const size_t block = line / block_size;
+	if (old_count == new_count) {
+		std::fill_n(lines.begin() + line, std::min(new_count, lines.size() - line), fresh);
+		const size_t last_block = (line + new_count - 1) / block_size;
+		for (size_t i = block; i <= last_block && i < blocks.size(); ++i) {
+			blocks[i].valid = false;
+		}
+		return true;
+	}
+	const auto first = lines.begin() + line;
+	lines.erase(first, first + std::min(old_count, lines.size() - line));
+	lines.insert(lines.begin() + line, new_count, fresh);
+	// every later line moved, so the later blocks have to be summarized again
+	blocks.resize(std::min(block, blocks.size()));
+	return true;
+}
+#endif
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <cctype>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -14,7 +15,12 @@ int main(int argc, const char** argv) {
 	std::string filename = argv[1];
 	std::ios_base::sync_with_stdio(false);
 	std::vector<std::string> args{argv + 2, argv + argc};
-	Editor editor{filename, args};
-	editor.start();
+	try {
+		Editor editor{filename, args};
+		editor.start();
+	} catch (const std::runtime_error& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
 	return 0;
 }
\ No newline at end of file
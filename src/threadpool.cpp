@@ -0,0 +1,57 @@
+#include "threadpool.hpp"
+
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#if defined(unix) || defined(__unix__) || defined(__unix)
+#include <csignal>
+
+#include <pthread.h>
+#endif
+ThreadPool::ThreadPool(size_t threads) {
+	for (size_t i = 0; i < threads; ++i) {
+		this->threads.emplace_back(&ThreadPool::work, this);
+	}
+}
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+		stopping = true;
+	}
+	available.notify_all();
+	for (auto& thread : threads) {
+		thread.join();
+	}
+}
+void ThreadPool::post(std::function<void()> job) {
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+		jobs.push(std::move(job));
+	}
+	available.notify_one();
+}
+size_t ThreadPool::size() const {
+	return threads.size();
+}
+void ThreadPool::work() {
+#if defined(unix) || defined(__unix__) || defined(__unix)
+	// signals are left to the thread that created the pool
+	sigset_t signals;
+	sigfillset(&signals);
+	pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+#endif
+	while (true) {
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock{mutex};
+			available.wait(lock, [this] { return stopping || !jobs.empty(); });
+			if (jobs.empty()) {
+				return;
+			}
+			job = std::move(jobs.front());
+			jobs.pop();
+		}
+		job();
+	}
+}
\ No newline at end of file
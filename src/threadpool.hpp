@@ -0,0 +1,27 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+class ThreadPool {
+   public:
+	explicit ThreadPool(size_t threads);
+	// finishes the queued jobs before returning
+	~ThreadPool();
+	ThreadPool(const ThreadPool& pool) = delete;
+	ThreadPool& operator=(const ThreadPool& pool) = delete;
+	void post(std::function<void()> job);
+	[[nodiscard]] size_t size() const;
+
+   private:
+	void work();
+	std::vector<std::thread> threads{};
+	std::queue<std::function<void()>> jobs{};
+	std::mutex mutex{};
+	std::condition_variable available{};
+	bool stopping{false};
+};
+#endif
\ No newline at end of file
@@ -9,4 +9,11 @@ std::string replace_all(std::string str, const std::string& search, const std::s
 		start_pos += replace.length();	// Handles case where 'search' is a substring of 'replace'
 	}
 	return str;
+}
+std::string trim(const std::string& str) {
+	const size_t start = str.find_first_not_of(" \t\r");
+	if (start == std::string::npos) {
+		return "";
+	}
+	return str.substr(start, str.find_last_not_of(" \t\r") + 1 - start);
 }
\ No newline at end of file
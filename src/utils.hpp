@@ -2,4 +2,6 @@
 #define UTILS_H
 #include <string>
 std::string replace_all(std::string str, const std::string& search, const std::string& replace);
+// removes leading and trailing whitespace
+std::string trim(const std::string& str);
 #endif
\ No newline at end of file
@@ -0,0 +1,351 @@
+#include "view.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer.hpp"
+#include "fileio.hpp"
+#include "position.hpp"
+namespace {
+const std::string highlight_start = "\033[7m";
+const std::string highlight_end = "\033[0m";
+// display width of a char starting with chr, tabs are displayed as spaces
+size_t cell_width(char chr, int tab_size) {
+	return chr == '\t' ? static_cast<size_t>(tab_size) : 1;
+}
+// display cells taken by line[0, end)
+size_t cells_before(const std::string& line, size_t end, int tab_size) {
+	size_t cells = 0;
+	for (size_t i = 0; i < end;) {
+		cells += cell_width(line[i], tab_size);
+		i += std::max<size_t>(utf8_char_size(line, i), 1);
+	}
+	return cells;
+}
+// renders the cells [col_start, col_start + cols) of line, padded to cols,
+// with the chars in [sel_start, sel_end) highlighted
+std::string render_row(const std::string& line, size_t sel_start, size_t sel_end, size_t col_start,
+					   int cols, int tab_size) {
+	std::string row;
+	const size_t end_cell = col_start + cols;
+	size_t cell = 0;
+	int cells = 0;
+	bool highlighted = false;
+	for (size_t i = 0; i < line.size() && cell < end_cell;) {
+		const auto chr = static_cast<unsigned char>(line[i]);
+		const size_t size = chr < 0x80 ? 1 : utf8_char_size(line, i);
+		const size_t width = cell_width(line[i], tab_size);
+		// chars scrolled off to the left are skipped, tabs may be cut in half
+		if (cell + width > col_start) {
+			const bool selected = i >= sel_start && i < sel_end;
+			if (selected != highlighted) {
+				row.append(selected ? highlight_start : highlight_end);
+				highlighted = selected;
+			}
+			if (chr == '\t') {
+				const size_t shown = std::min(cell + width, end_cell) - std::max(cell, col_start);
+				row.append(shown, ' ');
+				cells += static_cast<int>(shown);
+			} else if (chr < ' ' || chr == 0x7f || size == 0) {
+				// control chars and invalid utf-8 would mess up the terminal
+				row.push_back('?');
+				++cells;
+			} else {
+				row.append(line, i, size);
+				++cells;
+			}
+		}
+		cell += width;
+		i += std::max<size_t>(size, 1);
+	}
+	if (highlighted) {
+		row.append(highlight_end);
+	}
+	// pad instead of clearing to the end of the line so that views to the right are kept
+	row.append(cols - cells, ' ');
+	return row;
+}
+}  // namespace
+View::View(std::shared_ptr<Buffer> buffer, int tab_size)
+	: buffer{std::move(buffer)}, tab_size{tab_size} {}
+void View::show(std::shared_ptr<Buffer> new_buffer) {
+	buffer->last_cursor = {curr_line, col};
+	buffer->last_window_start = window_start;
+	buffer = std::move(new_buffer);
+	curr_line = buffer->last_cursor.line;
+	col = buffer->last_cursor.col;
+	window_start = buffer->last_window_start;
+	col_start = 0;
+	has_selection = false;
+	unfold_all();
+	clamp_cursor();
+}
+void View::scroll_to_cursor() {
+	const size_t cell = cells_before(buffer->lines[curr_line], col - 1, tab_size);
+	const auto cols = static_cast<size_t>(std::max(rect.cols, 1));
+	if (cell < col_start) {
+		col_start = cell;
+	} else if (cell >= col_start + cols) {
+		col_start = cell - cols + 1;
+	}
+	const auto rows = static_cast<size_t>(std::max(rect.rows, 1));
+	auto fold = fold_hiding(window_start);
+	if (fold != folds.end()) {
+		window_start = fold->line;
+	}
+	if (curr_line <= window_start) {
+		window_start = curr_line;
+		return;
+	}
+	// only walk the rows onscreen, so that folded lines are skipped without looking at them
+	size_t line = window_start;
+	for (size_t row = 1; row < rows; ++row) {
+		line = next_visible(line);
+		if (line >= curr_line) {
+			return;
+		}
+	}
+	window_start = curr_line;
+	for (size_t row = 1; row < rows && window_start > 0; ++row) {
+		window_start = prev_visible(window_start);
+	}
+}
+void View::clamp_cursor() {
+	const std::vector<std::string>& lines = buffer->lines;
+	curr_line = std::min(curr_line, lines.size() - 1);
+	col = std::min(col, lines[curr_line].size() + 1);
+	if (has_selection) {
+		selection_mark.line = std::min(selection_mark.line, lines.size() - 1);
+		selection_mark.col = std::min(selection_mark.col, lines[selection_mark.line].size() + 1);
+	}
+	reveal_cursor();
+	scroll_to_cursor();
+}
+std::pair<Position, Position> View::selection_bounds() const {
+	if (!has_selection) {
+		return {Position{curr_line, col}, Position{curr_line, col}};
+	}
+	return std::minmax(selection_mark, Position{curr_line, col});
+}
+void View::draw(std::ostringstream& out) {
+	// without a selection, moving the cursor doesn't change anything drawn
+	const auto [selection_start, selection_end] =
+		has_selection ? selection_bounds() : std::pair<Position, Position>{};
+	DrawState state{buffer.get(),	 buffer->version, folds_version, window_start,
+					col_start,		 selection_start, selection_end, rect};
+	if (state == drawn_state) {
+		return;
+	}
+	if (rect != std::get<Rect>(drawn_state)) {
+		drawn.assign(rect.rows, "");
+	}
+	drawn_state = state;
+	const std::vector<std::string>& lines = buffer->lines;
+	size_t line = window_start;
+	for (int row = 0; row < rect.rows; ++row, line = next_visible(line)) {
+		std::string text;
+		if (line < lines.size()) {
+			size_t start = 0;
+			size_t end = 0;
+			if (has_selection && line >= selection_start.line && line <= selection_end.line) {
+				start = line == selection_start.line ? selection_start.col - 1 : 0;
+				end = line == selection_end.line ? selection_end.col - 1 : std::string::npos;
+			}
+			auto fold = std::partition_point(folds.begin(), folds.end(),
+											 [&](const Fold& fold) { return fold.line < line; });
+			if (fold != folds.end() && fold->line == line) {
+				const size_t hidden_lines = fold->end - line;
+				const std::string summary = " ... (" + std::to_string(hidden_lines) +
+											(hidden_lines == 1 ? " line)" : " lines)");
+				text = render_row(lines[line] + summary, start, end, col_start, rect.cols,
+								  tab_size);
+			} else {
+				text = render_row(lines[line], start, end, col_start, rect.cols, tab_size);
+			}
+		} else {
+			text.assign(rect.cols, ' ');
+		}
+		if (text != drawn[row]) {
+			out << "\033[" << rect.top + row + 1 << ";" << rect.left + 1 << "H" << text;
+			drawn[row] = std::move(text);
+		}
+	}
+}
+std::pair<int, int> View::cursor_position() const {
+	const size_t cell = cells_before(buffer->lines[curr_line], col - 1, tab_size);
+	int row = 0;
+	for (size_t line = window_start; line < curr_line && row < rect.rows;
+		 line = next_visible(line)) {
+		++row;
+	}
+	// scroll_to_cursor keeps the cursor cell within the view
+	return {rect.top + row + 1, rect.left + static_cast<int>(cell - col_start) + 1};
+}
+std::vector<View::Fold>::const_iterator View::fold_hiding(size_t line) const {
+	// the last fold starting before line
+	auto fold = std::partition_point(folds.begin(), folds.end(),
+									 [&](const Fold& fold) { return fold.line < line; });
+	if (fold != folds.begin() && std::prev(fold)->end >= line) {
+		return std::prev(fold);
+	}
+	return folds.end();
+}
+void View::fold(size_t line, size_t end) {
+	if (end <= line || hidden(line)) {
+		return;
+	}
+	// folds inside the new one are replaced by it
+	auto first = std::partition_point(folds.begin(), folds.end(),
+									  [&](const Fold& fold) { return fold.line < line; });
+	auto last = std::partition_point(first, folds.end(),
+									 [&](const Fold& fold) { return fold.line <= end; });
+	folds.insert(folds.erase(first, last), Fold{line, end});
+	++folds_version;
+	if (curr_line > line && curr_line <= end) {
+		curr_line = line;
+		col = std::min(col, buffer->lines[curr_line].size() + 1);
+	}
+}
+bool View::unfold(size_t line) {
+	auto fold = std::partition_point(folds.begin(), folds.end(),
+									 [&](const Fold& fold) { return fold.line < line; });
+	if (fold == folds.end() || fold->line != line) {
+		return false;
+	}
+	folds.erase(fold);
+	++folds_version;
+	return true;
+}
+bool View::unfold_all() {
+	if (folds.empty()) {
+		return false;
+	}
+	folds.clear();
+	++folds_version;
+	return true;
+}
+bool View::hidden(size_t line) const {
+	return fold_hiding(line) != folds.end();
+}
+size_t View::next_visible(size_t line) const {
+	auto fold = std::partition_point(folds.begin(), folds.end(),
+									 [&](const Fold& fold) { return fold.line < line; });
+	if (fold != folds.end() && fold->line == line) {
+		return fold->end + 1;
+	}
+	return line + 1;
+}
+size_t View::prev_visible(size_t line) const {
+	if (line == 0) {
+		return 0;
+	}
+	auto fold = fold_hiding(line - 1);
+	return fold != folds.end() ? fold->line : line - 1;
+}
+void View::reveal_cursor() {
+	auto fold = fold_hiding(curr_line);
+	if (fold != folds.end()) {
+		folds.erase(fold);
+		++folds_version;
+	}
+}
+void View::edit(size_t line, size_t old_count, size_t new_count) {
+	if (folds.empty()) {
+		return;
+	}
+	std::vector<Fold> kept;
+	kept.reserve(folds.size());
+	for (const Fold& fold : folds) {
+		if (fold.end < line) {
+			kept.push_back(fold);
+		} else if (fold.line >= line + old_count) {
+			kept.push_back({fold.line + new_count - old_count, fold.end + new_count - old_count});
+		} else if (fold.line == line && old_count == 1 && new_count == 1) {
+			// only the text of the folded line changed
+			kept.push_back(fold);
+		}
+		// folds with hidden lines that were edited are unfolded
+	}
+	folds = std::move(kept);
+	++folds_version;
+}
+bool Layout::can_split(Rect rect, bool vertical) {
+	const Layout layout{0, vertical};
+	const auto [first_rect, second_rect] = layout.split_area(rect);
+	return std::min(first_rect.rows, second_rect.rows) >= min_rows &&
+		   std::min(first_rect.cols, second_rect.cols) >= min_cols;
+}
+std::pair<Rect, Rect> Layout::split_area(Rect rect) const {
+	Rect first_rect{rect};
+	Rect second_rect{rect};
+	if (vertical) {
+		// leave a column between them for the separator, views shrunk by resizing the terminal
+		// may end up with no columns at all
+		first_rect.cols = std::max((rect.cols - 1) / 2, 0);
+		second_rect.left = rect.left + first_rect.cols + 1;
+		second_rect.cols = std::max(rect.cols - first_rect.cols - 1, 0);
+	} else {
+		first_rect.rows = rect.rows / 2;
+		second_rect.top = rect.top + first_rect.rows;
+		second_rect.rows = rect.rows - first_rect.rows;
+	}
+	return {first_rect, second_rect};
+}
+void Layout::arrange(std::vector<View>& views, Rect rect) const {
+	if (!first) {
+		views[view].rect = rect;
+		return;
+	}
+	const auto [first_rect, second_rect] = split_area(rect);
+	first->arrange(views, first_rect);
+	second->arrange(views, second_rect);
+}
+void Layout::draw_separators(std::ostringstream& out, Rect rect) const {
+	if (!first) {
+		return;
+	}
+	const auto [first_rect, second_rect] = split_area(rect);
+	if (vertical) {
+		for (int row = 0; row < rect.rows; ++row) {
+			out << "\033[" << rect.top + row + 1 << ";" << second_rect.left << "H|";
+		}
+	}
+	first->draw_separators(out, first_rect);
+	second->draw_separators(out, second_rect);
+}
+void Layout::split(size_t old_view, size_t new_view, bool split_vertical) {
+	if (first) {
+		first->split(old_view, new_view, split_vertical);
+		second->split(old_view, new_view, split_vertical);
+	} else if (view == old_view) {
+		first = std::make_unique<Layout>(Layout{old_view});
+		second = std::make_unique<Layout>(Layout{new_view});
+		vertical = split_vertical;
+	}
+}
+void Layout::remove(size_t removed) {
+	if (!first) {
+		// views after the removed one move down in the vector
+		if (view > removed) {
+			--view;
+		}
+		return;
+	}
+	if (!first->first && first->view == removed) {
+		Layout sibling{std::move(*second)};
+		*this = std::move(sibling);
+	} else if (!second->first && second->view == removed) {
+		Layout sibling{std::move(*first)};
+		*this = std::move(sibling);
+	} else {
+		first->remove(removed);
+		second->remove(removed);
+		return;
+	}
+	remove(removed);  // renumber the sibling
+}
\ No newline at end of file
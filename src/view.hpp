@@ -0,0 +1,106 @@
+#ifndef VIEW_H
+#define VIEW_H
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "buffer.hpp"
+#include "position.hpp"
+// area of the screen, 0-indexed
+struct Rect {
+	int top{0};
+	int left{0};
+	int rows{0};
+	int cols{0};
+};
+inline bool operator==(const Rect& lhs, const Rect& rhs) {
+	return lhs.top == rhs.top && lhs.left == rhs.left && lhs.rows == rhs.rows &&
+		   lhs.cols == rhs.cols;
+}
+inline bool operator!=(const Rect& lhs, const Rect& rhs) {
+	return !operator==(lhs, rhs);
+}
+// a window onto a buffer with its own cursor, scroll position and selection
+class View {
+   public:
+	View(std::shared_ptr<Buffer> buffer, int tab_size);
+	// switches to another buffer, remembering the cursor in the current one
+	void show(std::shared_ptr<Buffer> new_buffer);
+	// adjusts window_start and col_start so that the cursor is onscreen
+	void scroll_to_cursor();
+	// keeps the cursor inside the buffer after its text was changed elsewhere
+	void clamp_cursor();
+	[[nodiscard]] std::pair<Position, Position> selection_bounds() const;
+	// draws the rows that changed since the last call
+	void draw(std::ostringstream& out);
+	// 1-indexed row and column of the cursor on the screen
+	[[nodiscard]] std::pair<int, int> cursor_position() const;
+
+	// hides lines (line, end], moving the cursor out of them, doesn't scroll
+	void fold(size_t line, size_t end);
+	// return false if nothing was folded
+	bool unfold(size_t line);
+	bool unfold_all();
+	[[nodiscard]] bool hidden(size_t line) const;
+	// the line shown after/before line, which must be visible, skipping folded lines
+	[[nodiscard]] size_t next_visible(size_t line) const;
+	[[nodiscard]] size_t prev_visible(size_t line) const;
+	// unfolds the folds hiding the cursor after it jumped
+	void reveal_cursor();
+	// lines [line, line + old_count) were replaced by new_count lines
+	void edit(size_t line, size_t old_count, size_t new_count);
+
+	std::shared_ptr<Buffer> buffer;
+	size_t window_start{0};
+	// first display cell shown of every row, for lines wider than the view
+	size_t col_start{0};
+	size_t curr_line{0};
+	size_t col{1};	// 1-indexed
+	Position selection_mark{};
+	bool has_selection{false};
+	Rect rect{};
+	int tab_size;
+
+   private:
+	struct Fold {
+		size_t line;
+		size_t end;
+	};
+	// the fold hiding line, or folds.end()
+	[[nodiscard]] std::vector<Fold>::const_iterator fold_hiding(size_t line) const;
+	// sorted and never nested, so that finding the fold around a line is a binary search
+	std::vector<Fold> folds{};
+	// incremented whenever folds changes
+	uint64_t folds_version{0};
+
+	// everything the drawn rows depend on, so unchanged views are skipped entirely
+	using DrawState =
+		std::tuple<const Buffer*, uint64_t, uint64_t, size_t, size_t, Position, Position, Rect>;
+	DrawState drawn_state{};
+	std::vector<std::string> drawn{};
+};
+// a tree of views, leaves show a view and other nodes split their area between 2 children
+struct Layout {
+	size_t view{0};
+	bool vertical{false};  // side by side instead of one above the other
+	std::unique_ptr<Layout> first{};
+	std::unique_ptr<Layout> second{};
+	// smallest size of either half of a split
+	static constexpr int min_rows = 2;
+	static constexpr int min_cols = 8;
+
+	void arrange(std::vector<View>& views, Rect rect) const;
+	void draw_separators(std::ostringstream& out, Rect rect) const;
+	// whether a view with rect is big enough to be split
+	[[nodiscard]] static bool can_split(Rect rect, bool vertical);
+	// shows new_view next to view
+	void split(size_t view, size_t new_view, bool vertical);
+	// removes view, its sibling takes over its area
+	void remove(size_t view);
+	[[nodiscard]] std::pair<Rect, Rect> split_area(Rect rect) const;
+};
+#endif
\ No newline at end of file